@@ -0,0 +1,62 @@
+#include <libxint/uint.hpp>
+
+#include "catch2/catch_amalgamated.hpp"
+
+#include "common.hpp"
+
+
+/*
+ * The operands are chosen so that safe types never overflow: the sum of two values one bit
+ * shorter than the type, the product of two half-width values, and so on.
+ */
+
+
+TEMPLATE_TEST_CASE_SIG("arithmetic", "[arithmetic]",
+                       BENCH_TYPES)
+{
+    using U = xint::uint<Bits, Safe>;
+
+    const U a = bench::random<U>(Bits - 1);
+    const U b = bench::random<U>(Bits - 1);
+    const U full = bench::random<U>();
+    const U ha = bench::random<U>(Bits / 2);
+    const U hb = bench::random<U>(Bits / 2);
+    const unsigned s = Bits / 3 + 1;
+    const U sa = bench::random<U>(Bits - s);
+    const U sb = sa << s; // safe types don't allow shifting out non-zero bits
+
+    BENCHMARK(bench::label<U>("a + b"))
+    {
+        return a + b;
+    };
+
+    BENCHMARK(bench::label<U>("a - b"))
+    {
+        return full - b;
+    };
+
+    BENCHMARK(bench::label<U>("a * b"))
+    {
+        return ha * hb;
+    };
+
+    BENCHMARK(bench::label<U>("a / b"))
+    {
+        return full / hb;
+    };
+
+    BENCHMARK(bench::label<U>("a % b"))
+    {
+        return full % hb;
+    };
+
+    BENCHMARK(bench::label<U>("a << s"))
+    {
+        return sa << s;
+    };
+
+    BENCHMARK(bench::label<U>("a >> s"))
+    {
+        return sb >> s;
+    };
+}
@@ -0,0 +1,69 @@
+#ifndef BENCHMARKS_COMMON_HPP
+#define BENCHMARKS_COMMON_HPP
+
+#include <cstdint>
+#include <random>
+#include <string>
+
+#include <libxint/uint.hpp>
+
+
+/*
+ * Every benchmark runs on these types: both local and heap storage, safe and unsafe.
+ * The limb size is chosen when compiling, there's one program for each.
+ */
+#define BENCH_TYPES                                             \
+    ((unsigned Bits, bool Safe), Bits, Safe),                   \
+    (64, false), (64, true),                                    \
+    (256, false), (256, true),                                  \
+    (1024, false), (1024, true),                                \
+    (2048, false), (2048, true),                                \
+    (4096, false), (4096, true),                                \
+    (16384, false), (16384, true)
+
+
+namespace bench {
+
+
+    inline
+    std::mt19937_64&
+    engine()
+    {
+        static std::mt19937_64 e{0x5eed};
+        return e;
+    }
+
+
+    // random value with exactly `bits` significant bits
+    template<xint::unsigned_integral U>
+    U
+    random(unsigned bits = U::num_bits)
+    {
+        // note: safe types don't allow shifting out non-zero bits
+        xint::uint<U::num_bits> r;
+        for (auto& x : r.limbs())
+            x = static_cast<xint::limb_type>(engine()());
+        r >>= U::num_bits - bits;
+        r.limb((bits - 1) / xint::limb_bits) |=
+            static_cast<xint::limb_type>(xint::limb_type{1} << (bits - 1) % xint::limb_bits);
+        return U{r};
+    }
+
+
+    // benchmark name, with everything needed to compare results across programs
+    template<xint::unsigned_integral U>
+    std::string
+    label(const std::string& op)
+    {
+        return op
+            + " [" + std::to_string(U::num_bits) + " bits"
+            + (U::is_safe ? ", safe" : ", unsafe")
+            + (U::is_local ? ", local" : ", heap")
+            + ", " + std::to_string(xint::limb_bits) + "-bit limbs]";
+    }
+
+
+} // namespace bench
+
+
+#endif
@@ -0,0 +1,138 @@
+/*
+ * Reporters that only write the benchmark results, in a format that other tools can
+ * read: "benchmark-csv" writes one line per benchmark, "benchmark-json" an array of
+ * objects. All times are in nanoseconds.
+ */
+
+#include <string>
+
+#include "catch2/catch_amalgamated.hpp"
+
+
+namespace {
+
+
+    std::string
+    csv_quote(const std::string& s)
+    {
+        std::string r = "\"";
+        for (char c : s) {
+            if (c == '"')
+                r += '"';
+            r += c;
+        }
+        return r + '"';
+    }
+
+
+    std::string
+    json_quote(const std::string& s)
+    {
+        std::string r = "\"";
+        for (char c : s) {
+            if (c == '"' || c == '\\')
+                r += '\\';
+            r += c;
+        }
+        return r + '"';
+    }
+
+
+    struct csv_reporter : Catch::StreamingReporterBase {
+
+        using StreamingReporterBase::StreamingReporterBase;
+
+
+        static
+        std::string
+        getDescription()
+        {
+            return "Writes the benchmark results as CSV";
+        }
+
+
+        void
+        testRunStarting(const Catch::TestRunInfo& info)
+            override
+        {
+            StreamingReporterBase::testRunStarting(info);
+            m_stream << "name,samples,iterations,mean,mean_low,mean_high,std_dev\n";
+        }
+
+
+        void
+        benchmarkEnded(const Catch::BenchmarkStats<>& stats)
+            override
+        {
+            m_stream << csv_quote(stats.info.name) << ','
+                     << stats.info.samples << ','
+                     << stats.info.iterations << ','
+                     << stats.mean.point.count() << ','
+                     << stats.mean.lower_bound.count() << ','
+                     << stats.mean.upper_bound.count() << ','
+                     << stats.standardDeviation.point.count() << '\n';
+        }
+
+    };
+
+
+    struct json_reporter : Catch::StreamingReporterBase {
+
+        using StreamingReporterBase::StreamingReporterBase;
+
+
+        static
+        std::string
+        getDescription()
+        {
+            return "Writes the benchmark results as a JSON array";
+        }
+
+
+        void
+        testRunStarting(const Catch::TestRunInfo& info)
+            override
+        {
+            StreamingReporterBase::testRunStarting(info);
+            m_stream << '[';
+        }
+
+
+        void
+        benchmarkEnded(const Catch::BenchmarkStats<>& stats)
+            override
+        {
+            m_stream << (first ? "\n" : ",\n")
+                     << "  {\"name\": " << json_quote(stats.info.name)
+                     << ", \"unit\": \"ns\""
+                     << ", \"samples\": " << stats.info.samples
+                     << ", \"iterations\": " << stats.info.iterations
+                     << ", \"mean\": " << stats.mean.point.count()
+                     << ", \"mean_low\": " << stats.mean.lower_bound.count()
+                     << ", \"mean_high\": " << stats.mean.upper_bound.count()
+                     << ", \"std_dev\": " << stats.standardDeviation.point.count()
+                     << '}';
+            first = false;
+        }
+
+
+        void
+        testRunEnded(const Catch::TestRunStats& stats)
+            override
+        {
+            m_stream << "\n]\n";
+            StreamingReporterBase::testRunEnded(stats);
+        }
+
+    private:
+
+        bool first = true;
+
+    };
+
+
+} // namespace
+
+
+CATCH_REGISTER_REPORTER("benchmark-csv", csv_reporter)
+CATCH_REGISTER_REPORTER("benchmark-json", json_reporter)
@@ -0,0 +1,27 @@
+#include <string>
+
+#include <libxint/uint.hpp>
+
+#include "catch2/catch_amalgamated.hpp"
+
+#include "common.hpp"
+
+
+TEMPLATE_TEST_CASE_SIG("serialization", "[serialization]",
+                       BENCH_TYPES)
+{
+    using U = xint::uint<Bits, Safe>;
+
+    const U a = bench::random<U>();
+    const std::string dec = a.to_dec();
+
+    BENCHMARK(bench::label<U>("to_dec"))
+    {
+        return a.to_dec();
+    };
+
+    BENCHMARK(bench::label<U>("string constructor"))
+    {
+        return U{dec, 10};
+    };
+}
@@ -0,0 +1,43 @@
+#include <libxint/prime.hpp>
+#include <libxint/uint.hpp>
+
+#include "catch2/catch_amalgamated.hpp"
+
+#include "common.hpp"
+
+
+TEMPLATE_TEST_CASE_SIG("stdlib", "[stdlib]",
+                       BENCH_TYPES)
+{
+    using U = xint::uint<Bits, Safe>;
+
+    const U a = bench::random<U>();
+    const U b = bench::random<U>();
+
+    BENCHMARK(bench::label<U>("gcd"))
+    {
+        return gcd(a, b);
+    };
+
+    // one full-width exponentiation takes too long past this size
+    if constexpr (Bits <= 2048) {
+        // powm() multiplies in U, so the modulus must have half the bits
+        U m = bench::random<U>(Bits / 2);
+        m.limb(0) |= 1;
+        const U x = bench::random<U>(Bits / 2 - 1);
+        const U y = bench::random<U>(Bits / 2);
+
+        BENCHMARK(bench::label<U>("powm"))
+        {
+            return powm(x, y, m);
+        };
+
+        // an odd number, most likely composite: that's one exponentiation
+        U n = a;
+        n.limb(0) |= 1;
+        BENCHMARK(bench::label<U>("miller_rabin"))
+        {
+            return xint::miller_rabin(n, 1, bench::engine());
+        };
+    }
+}
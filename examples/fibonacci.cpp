@@ -13,13 +13,12 @@ using std::hex;
 void print_fibo()
 {
     unsigned i = 0;
-    xint::uint<8192, true> a = 1, b = 0, c = b;
+    xint::uint<8192, true> a = 1, b = 0;
     try {
         for (;; ++i) {
             //cout << i << ": " << hex << b << dec << "\n";
-            c += a;
-            a = b;
-            b = c;
+            a += b;
+            swap(a, b); // only swaps the buffers
         }
     }
     catch (std::overflow_error&) {
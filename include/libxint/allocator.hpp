@@ -0,0 +1,186 @@
+#ifndef XINT_ALLOCATOR_HPP
+#define XINT_ALLOCATOR_HPP
+
+#include <algorithm> // max()
+#include <cstddef> // std::size_t
+#include <new>
+#include <type_traits>
+
+
+#ifndef XINT_HEAP_POOL_SIZE
+#define XINT_HEAP_POOL_SIZE 64
+#endif
+
+
+namespace xint {
+
+
+    namespace detail {
+
+        /*
+         * Per-thread list of free blocks, all with the same size and alignment.
+         *
+         * It's trivially destructible, so it can still be used while other thread_local
+         * objects are being destroyed; the guard below releases the blocks when the
+         * thread exits, and from then on blocks go straight back to operator delete.
+         */
+        template<std::size_t Size,
+                 std::size_t Align>
+        struct free_list {
+
+            struct node {
+                node* next;
+            };
+
+            static_assert(Size >= sizeof(node));
+
+
+            node* head = nullptr;
+            std::size_t count = 0;
+            bool dead = false;
+
+
+            static
+            void*
+            alloc_block()
+            {
+                return ::operator new(Size, std::align_val_t{Align});
+            }
+
+
+            static
+            void
+            free_block(void* p)
+                noexcept
+            {
+                ::operator delete(p, std::align_val_t{Align});
+            }
+
+
+            struct guard {
+
+                free_list& list;
+
+                ~guard()
+                {
+                    while (list.head) {
+                        node* n = list.head;
+                        list.head = n->next;
+                        free_block(n);
+                    }
+                    list.count = 0;
+                    list.dead = true;
+                }
+
+            };
+
+
+            static
+            free_list&
+            local()
+                noexcept
+            {
+                thread_local free_list list;
+                // frees the cached blocks at thread exit, also in threads that only push()
+                thread_local guard g{list};
+                return list;
+            }
+
+
+            static
+            void*
+            pop()
+            {
+                free_list& list = local();
+                if (!list.head)
+                    return alloc_block();
+                node* n = list.head;
+                list.head = n->next;
+                --list.count;
+                return n;
+            }
+
+
+            static
+            void
+            push(void* p)
+                noexcept
+            {
+                free_list& list = local();
+                if (list.dead || list.count >= XINT_HEAP_POOL_SIZE) {
+                    free_block(p);
+                    return;
+                }
+                list.head = ::new (p) node{list.head};
+                ++list.count;
+            }
+
+        };
+
+    } // namespace detail
+
+
+    /*
+     * Allocator that recycles single objects through a per-thread free list, holding up
+     * to XINT_HEAP_POOL_SIZE blocks. Arrays (n > 1) go straight to operator new.
+     *
+     * Blocks may be freed in a different thread than the one that allocated them; they
+     * simply end up in the free list of the thread that frees them.
+     */
+    template<typename T>
+    struct pool_allocator {
+
+        using value_type = T;
+        using is_always_equal = std::true_type;
+
+
+        constexpr pool_allocator() noexcept = default;
+
+        template<typename U>
+        constexpr pool_allocator(const pool_allocator<U>&) noexcept {}
+
+
+        T*
+        allocate(std::size_t n)
+        {
+            if (n == 1 && XINT_HEAP_POOL_SIZE > 0)
+                return static_cast<T*>(list_type::pop());
+            return static_cast<T*>(::operator new(n * sizeof(T),
+                                                  std::align_val_t{alignof(T)}));
+        }
+
+
+        void
+        deallocate(T* p,
+                   std::size_t n)
+            noexcept
+        {
+            if (n == 1 && XINT_HEAP_POOL_SIZE > 0)
+                list_type::push(p);
+            else
+                ::operator delete(p, std::align_val_t{alignof(T)});
+        }
+
+
+        template<typename U>
+        constexpr
+        bool
+        operator ==(const pool_allocator<U>&)
+            const noexcept
+        {
+            return true;
+        }
+
+    private:
+
+        // note: the block must be able to hold a node
+        using list_type = detail::free_list<std::max(sizeof(T), sizeof(void*)),
+                                            std::max(alignof(T), alignof(void*))>;
+
+    };
+
+
+}
+
+
+#endif
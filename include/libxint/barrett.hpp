@@ -0,0 +1,127 @@
+#ifndef XINT_BARRETT_HPP
+#define XINT_BARRETT_HPP
+
+#include <algorithm>
+#include <ranges>
+#include <span>
+#include <stdexcept>
+#include <utility> // pair
+
+#include "eval-assignment.hpp"
+#include "eval-bits.hpp"
+#include "eval-comparison.hpp"
+#include "eval-inc-dec.hpp"
+#include "eval-multiplication.hpp"
+#include "eval-subtraction.hpp"
+#include "traits.hpp"
+#include "uint.hpp"
+
+
+namespace xint {
+
+
+    /*
+     * Context for repeated division by the same modulus m, using Barrett reduction.
+     *
+     * With B = 2^limb_bits, n the number of significant limbs in m, and L = max(2n,
+     * U::num_limbs), it precomputes mu = floor(B^L / m); when m uses all the limbs of
+     * U, this is floor(4^k / m). Then any x in U is divided with two multiplications
+     * and at most two correction steps (HAC 14.42.) Unlike montgomery<>, m may be even.
+     */
+    template<unsigned_integral U>
+    class barrett {
+
+        static constexpr std::size_t N = U::num_limbs;
+
+        // mu has at most L - n + 2 limbs, so N + 2
+        using mu_type = uint<(N + 2) * limb_bits>;
+        // q1 * mu, and B^L for the initial division
+        using product_type = uint<(2 * N + 2) * limb_bits>;
+        // the remainder is calculated modulo B^(n + 1)
+        using rem_type = uint<(N + 1) * limb_bits>;
+
+        U m_;
+        mu_type mu_;
+        std::size_t n_;
+        std::size_t l_;
+
+    public:
+
+        using value_type = U;
+
+
+        explicit
+        barrett(const U& m) :
+            m_{m}
+        {
+            const unsigned m_width = eval_bit_width(m.limbs());
+            if (!m_width)
+                throw std::domain_error{"division by zero"};
+
+            n_ = (m_width - 1) / limb_bits + 1;
+            l_ = std::max(2 * n_, N);
+
+            product_type num = 0;
+            num.limb(l_) = 1;
+            mu_ = div(num, m_).first;
+        }
+
+
+        const U& modulus() const noexcept { return m_; }
+
+
+        // {x / m, x % m}
+        std::pair<U, U>
+        divmod(const U& x)
+            const
+        {
+            const std::size_t n = n_;
+            std::pair<U, U> result;
+            auto& [q, r] = result;
+
+            // note: spans make the sub-ranges cheap to index
+            const std::span<const limb_type> xs = x.limbs();
+            const std::span<const limb_type> ms = std::span{m_.limbs()}.first(n);
+
+            // q = ((x >> (n-1) limbs) * mu) >> (L-n+1) limbs, at most 2 less than x / m
+            auto q1 = xs.subspan(n - 1);
+            // note: mu == B^(L-n+1) when m == B^(n-1)
+            auto mu = std::span{mu_.limbs()}.first(l_ - n + 2);
+            product_type prod;
+            auto p = std::span{prod.limbs()}.first(q1.size() + mu.size());
+            eval_mul_simple(p, q1, mu);
+            eval_assign(q.limbs(), p.subspan(l_ - n + 1));
+
+            // r = x - q * m, only the lower n+1 limbs are needed since it's less than 3m
+            rem_type qm;
+            rem_type rr;
+            auto qm_low = std::span{qm.limbs()}.first(n + 1);
+            auto rr_low = std::span{rr.limbs()}.first(n + 1);
+            eval_mul_simple(qm_low, q.limbs(), ms);
+            eval_sub(rr_low, xs.first(std::min(n + 1, N)), qm_low);
+
+            while (eval_compare_three_way(rr_low, ms) >= 0) {
+                eval_sub_inplace(rr_low, ms);
+                eval_increment(q.limbs());
+            }
+            eval_assign(r.limbs(), rr_low);
+
+            return result;
+        }
+
+
+        // x % m
+        U
+        reduce(const U& x)
+            const
+        {
+            return divmod(x).second;
+        }
+
+    };
+
+
+}
+
+
+#endif
@@ -0,0 +1,126 @@
+#ifndef XINT_CHARCONV_HPP
+#define XINT_CHARCONV_HPP
+
+#include <bit>
+#include <charconv>
+#include <cstddef> // std::size_t
+#include <cstring> // memcpy(), memmove()
+#include <system_error>
+#include <utility> // move()
+
+#include "eval-bits.hpp"
+#include "eval-division.hpp"
+#include "eval-radix.hpp"
+#include "traits.hpp"
+#include "uint.hpp"
+
+
+/*
+ * Conversion to and from characters, with the same interface as std::to_chars() and
+ * std::from_chars(): no locale, no prefix, no exceptions.
+ *
+ * For types with local storage nothing is allocated. Types with heap storage only
+ * allocate one temporary uint, so they can throw std::bad_alloc; the digits always come
+ * from eval_to_chars_simple(), never from the divide and conquer of eval_to_chars().
+ */
+
+
+namespace xint {
+
+
+    template<unsigned_integral U>
+    std::to_chars_result
+    to_chars(char* first,
+             char* last,
+             const U& value,
+             int base = 10)
+        noexcept(U::is_local)
+    {
+        if (base < 2 || base > 36)
+            return {first, std::errc::invalid_argument};
+
+        const unsigned ubase = static_cast<unsigned>(base);
+        const std::size_t room = static_cast<std::size_t>(last - first);
+        const std::size_t width = eval_bit_width(value.limbs());
+
+        if (!width) {
+            if (!room)
+                return {last, std::errc::value_too_large};
+            *first = '0';
+            return {first + 1, std::errc{}};
+        }
+
+        if (std::has_single_bit(ubase)) {
+            const unsigned shift = std::bit_width(ubase) - 1;
+            const std::size_t digits = (width + shift - 1) / shift;
+            if (digits > room)
+                return {last, std::errc::value_too_large};
+            detail::to_chars_pow2(first + digits, value.limbs(), ubase, detail::lower_digits, 0);
+            return {first + digits, std::errc{}};
+        }
+
+        /*
+         * The digits are written backwards, ending at `last`, then moved to the front.
+         * max_digits() can be up to 2 digits too large, so when the buffer is that close
+         * to it, the last digits are split off first.
+         */
+        const std::size_t bound = max_digits(width, ubase);
+        if (bound > room + 2)
+            return {last, std::errc::value_too_large};
+        std::size_t split = bound > room ? bound - room : 0;
+
+        U n = value;
+        char tail[2];
+        for (std::size_t i = split; i-- > 0;)
+            tail[i] = detail::lower_digits[eval_div_inplace_limb(n.limbs(), ubase)];
+
+        char* p = eval_to_chars_simple(last, n.limbs(), ubase, false);
+
+        const std::size_t len = static_cast<std::size_t>(last - p);
+        const char* t = tail;
+        if (!len) // the split digits may have leading zeros
+            while (split > 1 && *t == '0') {
+                ++t;
+                --split;
+            }
+        if (len + split > room)
+            return {last, std::errc::value_too_large};
+
+        std::memmove(first, p, len);
+        std::memcpy(first + len, t, split);
+        return {first + len + split, std::errc{}};
+    }
+
+
+    /*
+     * Reads as many digits as possible; `value` is only modified on success.
+     * Letters may be in either case.
+     */
+    template<unsigned_integral U>
+    std::from_chars_result
+    from_chars(const char* first,
+               const char* last,
+               U& value,
+               int base = 10)
+        noexcept(U::is_local)
+    {
+        if (base < 2 || base > 36)
+            return {first, std::errc::invalid_argument};
+
+        const unsigned ubase = static_cast<unsigned>(base);
+        const char* end = scan_digits(first, last, ubase);
+        if (end == first)
+            return {first, std::errc::invalid_argument};
+
+        U result;
+        if (eval_from_chars(result.limbs(), first, end, ubase) != parse_status::success)
+            return {end, std::errc::result_out_of_range};
+        value = std::move(result);
+        return {end, std::errc{}};
+    }
+
+
+}
+
+
+#endif
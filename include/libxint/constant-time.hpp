@@ -0,0 +1,162 @@
+#ifndef XINT_CONSTANT_TIME_HPP
+#define XINT_CONSTANT_TIME_HPP
+
+#include <stdexcept>
+#include <utility> // pair
+
+#include "eval-constant-time.hpp"
+#include "montgomery.hpp"
+#include "traits.hpp"
+#include "uint.hpp"
+
+
+/*
+ * Constant-time arithmetic, for values that must not leak through timing.
+ *
+ * The regular operators stop early on zero limbs, on carries that don't propagate,
+ * and so on. The functions in the xint::ct namespace always do the same work for a
+ * given type: no branch and no memory access depends on the values. Sizes, and
+ * the modulus in powm(), are considered public.
+ *
+ * Arithmetic always wraps around, even for safe types; there's no overflow check,
+ * since that would be a branch on the result.
+ */
+
+
+namespace xint::ct {
+
+
+    // a + b, wrapping around
+    template<unsigned_integral U>
+    U
+    add(const U& a,
+        const U& b)
+        noexcept
+    {
+        U result;
+        eval_add(result.limbs(), a.limbs(), b.limbs());
+        return result;
+    }
+
+
+    // a - b, wrapping around
+    template<unsigned_integral U>
+    U
+    sub(const U& a,
+        const U& b)
+        noexcept
+    {
+        U result;
+        eval_sub(result.limbs(), a.limbs(), b.limbs());
+        return result;
+    }
+
+
+    template<unsigned_integral UA,
+             unsigned_integral UB>
+    bool
+    less(const UA& a,
+         const UB& b)
+        noexcept
+    {
+        return eval_less(a.limbs(), b.limbs());
+    }
+
+
+    template<unsigned_integral UA,
+             unsigned_integral UB>
+    bool
+    equal(const UA& a,
+          const UB& b)
+        noexcept
+    {
+        return eval_equal(a.limbs(), b.limbs());
+    }
+
+
+    // cond ? a : b
+    template<unsigned_integral U>
+    U
+    select(bool cond,
+           const U& a,
+           const U& b)
+        noexcept
+    {
+        U result;
+        eval_select(result.limbs(), mask(cond), a.limbs(), b.limbs());
+        return result;
+    }
+
+
+    // swap a and b if cond is true
+    template<unsigned_integral U>
+    void
+    cswap(bool cond,
+          U& a,
+          U& b)
+        noexcept
+    {
+        eval_cswap(mask(cond), a.limbs(), b.limbs());
+    }
+
+
+    /*
+     * Division with a fixed number of iterations, one per bit of UA.
+     * Only division by zero is detected, since that's not a secret.
+     */
+    template<unsigned_integral UA,
+             unsigned_integral UB>
+    std::pair<UA, UB>
+    div(const UA& a,
+        const UB& b)
+    {
+        if (eval_is_zero(b.limbs()))
+            throw std::domain_error{"division by zero"};
+
+        std::pair<UA, UB> result;
+        uint<UB::num_bits + limb_bits> t;
+        eval_div(result.first.limbs(),
+                 result.second.limbs(),
+                 a.limbs(),
+                 b.limbs(),
+                 t.limbs());
+        return result;
+    }
+
+
+    /*
+     * x^y mod m, using the Montgomery ladder: every bit of y, including the leading
+     * zeros, costs one multiplication and one squaring.
+     * The modulus must be odd.
+     */
+    template<unsigned_integral U,
+             unsigned_integral E>
+    U
+    powm(const U& x,
+         const E& y,
+         const U& m)
+    {
+        const montgomery<U, true> mont{m};
+
+        U r0 = mont.one();
+        U r1 = mont.to_mont(ct::div(x, m).second);
+
+        // invariant: r1 = r0 * x; the swap back is deferred to the next bit
+        limb_type prev = 0;
+        for (unsigned i = E::num_bits; i-- > 0;) {
+            const limb_type bit = (y.limb(i / limb_bits) >> (i % limb_bits)) & 1;
+            eval_cswap(mask(bit ^ prev), r0.limbs(), r1.limbs());
+            r1 = mont.mul(r0, r1);
+            r0 = mont.sqr(r0);
+            prev = bit;
+        }
+        eval_cswap(mask(prev), r0.limbs(), r1.limbs());
+
+        return mont.from_mont(r0);
+    }
+
+
+} // namespace xint::ct
+
+
+#endif
@@ -0,0 +1,603 @@
+#ifndef XINT_DISPATCH_HPP
+#define XINT_DISPATCH_HPP
+
+#include <algorithm> // fill_n()
+#include <atomic>
+#include <cstddef> // std::size_t
+#include <cstdlib> // getenv()
+#include <iterator> // size()
+#include <stdexcept>
+#include <string_view>
+
+#include "intrinsics.hpp"
+#include "simd.hpp"
+#include "types.hpp"
+
+
+/*
+ * The low level loops used by the eval_* kernels, on raw limb pointers:
+ *
+ *     add_n(), sub_n()       out = a +/- b, over n limbs
+ *     mul_1(), addmul_1()    out = a * limb, out += a * limb
+ *     mont_mul()             the rows of a Montgomery multiplication
+ *     mul_n()                out = a * b, over n limbs; only on avx512ifma
+ *
+ * Each backend implements all of them (hw::portable is plain C++, the others come from
+ * intrinsics.hpp and simd.hpp.) With XINT_DISPATCH the backend is picked at run time, so
+ * one binary uses mulx on the CPUs that have it and still runs on the ones that don't;
+ * it's the default on x86-64, unless the target is already known to have ADX and
+ * XINT_USE_SIMD is off. Otherwise the backend is picked at compile time.
+ *
+ * The backend is resolved on the first call: it's the one named by the XINT_BACKEND
+ * environment variable, when the CPU supports it, or the best one the CPU supports.
+ * set_backend() can force a specific backend for testing.
+ */
+
+
+#ifndef XINT_DISPATCH
+#if defined(XINT_HW_X86_64) && (!defined(XINT_HW_ADX) || defined(XINT_HW_SIMD))
+#define XINT_DISPATCH 1
+#else
+#define XINT_DISPATCH 0
+#endif
+#endif
+
+
+namespace xint::hw {
+
+
+    namespace portable {
+
+        // out[0, n) = a[0, n) + b[0, n); returns the carry
+        constexpr
+        limb_type
+        add_n(limb_type* out,
+              const limb_type* a,
+              const limb_type* b,
+              std::size_t n)
+            noexcept
+        {
+            wide_limb_type sum = 0;
+            for (std::size_t i = 0; i < n; ++i) {
+                sum += wide_limb_type{a[i]} + b[i];
+                out[i] = static_cast<limb_type>(sum);
+                sum >>= limb_bits;
+            }
+            return static_cast<limb_type>(sum);
+        }
+
+
+        // out[0, n) = a[0, n) - b[0, n); returns the borrow
+        constexpr
+        limb_type
+        sub_n(limb_type* out,
+              const limb_type* a,
+              const limb_type* b,
+              std::size_t n)
+            noexcept
+        {
+            signed_wide_limb_type diff = 0;
+            for (std::size_t i = 0; i < n; ++i) {
+                diff += a[i];
+                diff -= b[i];
+                out[i] = static_cast<limb_type>(diff);
+                diff >>= limb_bits;
+            }
+            return diff ? 1 : 0;
+        }
+
+
+        // out[0, n) = a[0, n) * b; returns the high limb
+        constexpr
+        limb_type
+        mul_1(limb_type* out,
+              const limb_type* a,
+              std::size_t n,
+              limb_type b)
+            noexcept
+        {
+            wide_limb_type carry = 0;
+            for (std::size_t j = 0; j < n; ++j) {
+                carry += a[j] * wide_limb_type{b};
+                out[j] = static_cast<limb_type>(carry);
+                carry >>= limb_bits;
+            }
+            return static_cast<limb_type>(carry);
+        }
+
+
+        // out[0, n) += a[0, n) * b; returns the limb carried out of out[n - 1]
+        constexpr
+        limb_type
+        addmul_1(limb_type* out,
+                 const limb_type* a,
+                 std::size_t n,
+                 limb_type b)
+            noexcept
+        {
+            const wide_limb_type wb = b;
+            wide_limb_type carry = 0;
+            for (std::size_t j = 0; j < n; ++j) {
+                // note: this can't overflow, (2^n-1)^2 + 2*(2^n-1) == 2^(2n) - 1
+                carry += wb * a[j] + out[j];
+                out[j] = static_cast<limb_type>(carry);
+                carry >>= limb_bits;
+            }
+            return static_cast<limb_type>(carry);
+        }
+
+    } // namespace portable
+
+
+    using addmul_1_type = limb_type (*)(limb_type*,
+                                        const limb_type*,
+                                        std::size_t,
+                                        limb_type) noexcept;
+
+
+    /*
+     * t[n, 2n] = a * b / R, where R = 2^(limb_bits * n); the result is less than 2m.
+     * This is the CIOS method, one addmul_1() row for a * b[i] and one for the
+     * reduction, but row i is added at t + i instead of shifting t down every time.
+     * There are no branches on the values.
+     * Notes:
+     *     - `a`, `b` and `m` have n limbs, `t` has 2n + 1 limbs.
+     *     - `m_inv` is -m^-1 mod 2^limb_bits.
+     */
+    template<addmul_1_type AddMul>
+    void
+    mont_mul_rows(limb_type* t,
+                  const limb_type* a,
+                  const limb_type* b,
+                  const limb_type* m,
+                  limb_type m_inv,
+                  std::size_t n)
+        noexcept
+    {
+        std::fill_n(t, 2 * n + 1, 0);
+        for (std::size_t i = 0; i < n; ++i) {
+            // t[i + n + 1] is not written before this row
+            limb_type* const row = t + i;
+            wide_limb_type c = wide_limb_type{row[n]} + AddMul(row, a, n, b[i]);
+            row[n] = static_cast<limb_type>(c);
+            row[n + 1] = static_cast<limb_type>(c >> limb_bits);
+
+            // mi makes row[0] zero
+            const limb_type mi = static_cast<limb_type>(row[0] * m_inv);
+            c = wide_limb_type{row[n]} + AddMul(row, m, n, mi);
+            row[n] = static_cast<limb_type>(c);
+            row[n + 1] = static_cast<limb_type>(row[n + 1] + (c >> limb_bits));
+        }
+    }
+
+
+#ifdef XINT_HW_SIMD
+
+    /*
+     * mont_mul() for the vector backends: Vector from MinLimbs to simd::max_limbs limbs,
+     * the rows of AddMul for the others.
+     */
+    template<auto Vector,
+             std::size_t MinLimbs,
+             addmul_1_type AddMul>
+    void
+    mont_mul_simd(limb_type* t,
+                  const limb_type* a,
+                  const limb_type* b,
+                  const limb_type* m,
+                  limb_type m_inv,
+                  std::size_t n)
+        noexcept
+    {
+        if (n >= MinLimbs && n <= simd::max_limbs)
+            Vector(t, a, b, m, m_inv, n);
+        else
+            mont_mul_rows<AddMul>(t, a, b, m, m_inv, n);
+    }
+
+#endif // XINT_HW_SIMD
+
+
+    enum class backend : unsigned char {
+        portable,   // plain C++
+        x86_64,     // adc/sbb
+        avx2,       // adc/sbb, AVX2 Montgomery multiplication for large operands
+        adx,        // adc/sbb, mulx with adcx/adox
+        avx512ifma, // adc/sbb, mulx with adcx/adox, AVX-512 IFMA for large operands
+    };
+
+
+    struct kernel_table {
+
+        backend id;
+        const char* name;
+
+        limb_type (*add_n)(limb_type*,
+                           const limb_type*,
+                           const limb_type*,
+                           std::size_t) noexcept;
+
+        limb_type (*sub_n)(limb_type*,
+                           const limb_type*,
+                           const limb_type*,
+                           std::size_t) noexcept;
+
+        addmul_1_type mul_1;
+
+        addmul_1_type addmul_1;
+
+        void (*mont_mul)(limb_type*,
+                         const limb_type*,
+                         const limb_type*,
+                         const limb_type*,
+                         limb_type,
+                         std::size_t) noexcept;
+
+        // null when the backend has nothing faster than the rows of mul_1() and addmul_1()
+        void (*mul_n)(limb_type*,
+                      const limb_type*,
+                      const limb_type*,
+                      std::size_t) noexcept;
+
+    };
+
+
+    // all the backends compiled in, from the slowest to the fastest
+    inline constexpr kernel_table kernel_tables[] = {
+        {
+            backend::portable,
+            "portable",
+            portable::add_n,
+            portable::sub_n,
+            portable::mul_1,
+            portable::addmul_1,
+            mont_mul_rows<portable::addmul_1>,
+            nullptr,
+        },
+#ifdef XINT_HW_X86_64
+        {
+            backend::x86_64,
+            "x86-64",
+            x86_64::add_n,
+            x86_64::sub_n,
+            portable::mul_1,
+            portable::addmul_1,
+            mont_mul_rows<portable::addmul_1>,
+            nullptr,
+        },
+#ifdef XINT_HW_SIMD
+        {
+            backend::avx2,
+            "avx2",
+            x86_64::add_n,
+            x86_64::sub_n,
+            portable::mul_1,
+            portable::addmul_1,
+            mont_mul_simd<avx2::mont_mul, simd::avx2_min_limbs, portable::addmul_1>,
+            nullptr,
+        },
+#endif
+        {
+            backend::adx,
+            "adx",
+            x86_64::add_n,
+            x86_64::sub_n,
+            adx::mul_1,
+            adx::addmul_1,
+            mont_mul_rows<adx::addmul_1>,
+            nullptr,
+        },
+#ifdef XINT_HW_SIMD
+        {
+            backend::avx512ifma,
+            "avx512ifma",
+            x86_64::add_n,
+            x86_64::sub_n,
+            adx::mul_1,
+            adx::addmul_1,
+            mont_mul_simd<avx512ifma::mont_mul, simd::min_limbs, adx::addmul_1>,
+            avx512ifma::mul_n,
+        },
+#endif
+#endif
+    };
+
+
+    // the kernels of backend `b`, or null if it's not compiled in
+    constexpr
+    const kernel_table*
+    find_kernels(backend b)
+        noexcept
+    {
+        for (const auto& k : kernel_tables)
+            if (k.id == b)
+                return &k;
+        return nullptr;
+    }
+
+
+    // true if backend `b` is compiled in, and the CPU can run it
+    inline
+    bool
+    supported(backend b)
+        noexcept
+    {
+        if (!find_kernels(b))
+            return false;
+#ifdef XINT_HW_X86_64
+        __builtin_cpu_init();
+        const bool has_adx = __builtin_cpu_supports("adx") && __builtin_cpu_supports("bmi2");
+        switch (b) {
+            case backend::avx2:
+                return __builtin_cpu_supports("avx2");
+            case backend::adx:
+                return has_adx;
+            case backend::avx512ifma:
+                return has_adx
+                    && __builtin_cpu_supports("avx512f")
+                    && __builtin_cpu_supports("avx512ifma");
+            default:
+                return true;
+        }
+#else
+        return true;
+#endif
+    }
+
+
+    // the fastest backend the CPU can run
+    inline
+    backend
+    best_backend()
+        noexcept
+    {
+        for (std::size_t i = std::size(kernel_tables); i-- > 0;)
+            if (supported(kernel_tables[i].id))
+                return kernel_tables[i].id;
+        return backend::portable;
+    }
+
+
+#if XINT_DISPATCH
+
+    namespace detail {
+
+        inline std::atomic<const kernel_table*> active_kernels = nullptr;
+
+
+        inline
+        const kernel_table*
+        resolve_kernels()
+            noexcept
+        {
+            const kernel_table* k = nullptr;
+            if (const char* env = std::getenv("XINT_BACKEND"))
+                for (const auto& t : kernel_tables)
+                    if (std::string_view{env} == t.name && supported(t.id))
+                        k = &t;
+            if (!k)
+                k = find_kernels(best_backend());
+            active_kernels.store(k, std::memory_order_relaxed);
+            return k;
+        }
+
+    } // namespace detail
+
+
+    // the kernels in use
+    inline
+    const kernel_table&
+    kernels()
+        noexcept
+    {
+        const kernel_table* k = detail::active_kernels.load(std::memory_order_relaxed);
+        if (!k) [[unlikely]]
+            k = detail::resolve_kernels();
+        return *k;
+    }
+
+
+    inline
+    backend
+    current_backend()
+        noexcept
+    {
+        return kernels().id;
+    }
+
+
+    // use backend `b` from now on, in all threads
+    inline
+    void
+    set_backend(backend b)
+    {
+        if (!supported(b))
+            throw std::invalid_argument{"backend not supported"};
+        detail::active_kernels.store(find_kernels(b), std::memory_order_relaxed);
+    }
+
+
+    /*
+     * The entry points used by the kernels. They're not constexpr: the kernels call the
+     * hw::portable versions during constant evaluation.
+     */
+
+    // add_n() and sub_n() may use the carry flag
+    inline constexpr bool fast_add_n = true;
+    // mul_1() and addmul_1() may use mulx
+    inline constexpr bool fast_mul_1 = true;
+#ifdef XINT_HW_SIMD
+    // mul_n() may be used, for `simd::min_limbs` to `simd::max_limbs` limbs
+    inline constexpr bool has_mul_n = true;
+#else
+    inline constexpr bool has_mul_n = false;
+#endif
+
+
+    // true if the current backend has mul_n()
+    inline
+    bool
+    fast_mul_n()
+        noexcept
+    {
+        return kernels().mul_n != nullptr;
+    }
+
+
+    inline
+    limb_type
+    add_n(limb_type* out,
+          const limb_type* a,
+          const limb_type* b,
+          std::size_t n)
+        noexcept
+    {
+        return kernels().add_n(out, a, b, n);
+    }
+
+
+    inline
+    limb_type
+    sub_n(limb_type* out,
+          const limb_type* a,
+          const limb_type* b,
+          std::size_t n)
+        noexcept
+    {
+        return kernels().sub_n(out, a, b, n);
+    }
+
+
+    inline
+    limb_type
+    mul_1(limb_type* out,
+          const limb_type* a,
+          std::size_t n,
+          limb_type b)
+        noexcept
+    {
+        return kernels().mul_1(out, a, n, b);
+    }
+
+
+    inline
+    limb_type
+    addmul_1(limb_type* out,
+             const limb_type* a,
+             std::size_t n,
+             limb_type b)
+        noexcept
+    {
+        return kernels().addmul_1(out, a, n, b);
+    }
+
+
+    inline
+    void
+    mont_mul(limb_type* t,
+             const limb_type* a,
+             const limb_type* b,
+             const limb_type* m,
+             limb_type m_inv,
+             std::size_t n)
+        noexcept
+    {
+        kernels().mont_mul(t, a, b, m, m_inv, n);
+    }
+
+
+    // out[0, 2n) = a[0, n) * b[0, n); only when fast_mul_n() is true
+    inline
+    void
+    mul_n(limb_type* out,
+          const limb_type* a,
+          const limb_type* b,
+          std::size_t n)
+        noexcept
+    {
+        kernels().mul_n(out, a, b, n);
+    }
+
+#else // XINT_DISPATCH
+
+    // the entry points used by the kernels, picked at compile time
+
+#if defined(XINT_HW_X86_64)
+    namespace add_ns = x86_64;
+    inline constexpr bool fast_add_n = true;
+#elif defined(XINT_HW_ADDC)
+    namespace add_ns = addc;
+    inline constexpr bool fast_add_n = true;
+#else
+    namespace add_ns = portable;
+    inline constexpr bool fast_add_n = false;
+#endif
+
+#ifdef XINT_HW_ADX
+    namespace mul_ns = adx;
+    inline constexpr bool fast_mul_1 = true;
+#else
+    namespace mul_ns = portable;
+    inline constexpr bool fast_mul_1 = false;
+#endif
+
+    inline constexpr bool has_mul_n = false;
+
+    using add_ns::add_n;
+    using add_ns::sub_n;
+    using mul_ns::mul_1;
+    using mul_ns::addmul_1;
+
+
+    constexpr
+    bool
+    fast_mul_n()
+        noexcept
+    {
+        return false;
+    }
+
+
+    // out[0, 2n) = a[0, n) * b[0, n), one row at a time
+    inline
+    void
+    mul_n(limb_type* out,
+          const limb_type* a,
+          const limb_type* b,
+          std::size_t n)
+        noexcept
+    {
+        out[n] = mul_1(out, a, n, b[0]);
+        for (std::size_t i = 1; i < n; ++i)
+            out[n + i] = addmul_1(out + i, a, n, b[i]);
+    }
+
+
+    inline
+    void
+    mont_mul(limb_type* t,
+             const limb_type* a,
+             const limb_type* b,
+             const limb_type* m,
+             limb_type m_inv,
+             std::size_t n)
+        noexcept
+    {
+        mont_mul_rows<mul_ns::addmul_1>(t, a, b, m, m_inv, n);
+    }
+
+#endif // XINT_DISPATCH
+
+
+#ifndef XINT_HW_FIXED_LIMBS
+#define XINT_HW_FIXED_LIMBS 4
+#endif
+
+    // the eval_*_fixed() kernels up to this size stay unrolled, without these functions
+    inline constexpr std::size_t fixed_limbs = XINT_HW_FIXED_LIMBS;
+
+
+} // namespace xint::hw
+
+
+#endif
@@ -2,9 +2,13 @@
 #define XINT_EVAL_ADDITION_HPP
 
 #include <algorithm>
+#include <array>
+#include <cstddef> // std::size_t
 #include <limits>
 #include <ranges>
+#include <type_traits> // is_constant_evaluated()
 
+#include "dispatch.hpp"
 #include "types.hpp"
 #include "utils.hpp"
 
@@ -12,10 +16,34 @@
 namespace xint {
 
 
+    namespace detail {
+
+        /*
+         * out[0, n) = a[0, n) + b[0, n)
+         * `out` may alias `a` or `b`.
+         * @return the carry (0 or 1)
+         */
+        constexpr
+        limb_type
+        add_n(limb_type* out,
+              const limb_type* a,
+              const limb_type* b,
+              std::size_t n)
+            noexcept
+        {
+            if (std::is_constant_evaluated())
+                return hw::portable::add_n(out, a, b, n);
+            return hw::add_n(out, a, b, n);
+        }
+
+    } // namespace detail
+
+
     /** out = a + b
      * TESTED
      * @return true if there's overflow
      */
+    constexpr
     bool
     eval_add(limb_range auto&& out,
              const limb_range auto& a,
@@ -28,7 +56,16 @@ namespace xint {
         using std::size;
 
         wide_limb_type sum = 0;
-        for (std::size_t i = 0; i < size(out); ++i) {
+        std::size_t i = 0;
+        if (!shift) {
+            // the limbs where all overlap
+            i = std::min({size(out), size(a), size(b)});
+            sum = detail::add_n(std::ranges::data(out),
+                                std::ranges::data(a),
+                                std::ranges::data(b),
+                                i);
+        }
+        for (; i < size(out); ++i) {
             if (i < size(a))
                 sum += a[i];
             if (i >= shift && i < size(b) + shift)
@@ -57,8 +94,37 @@ namespace xint {
     }
 
 
+    /*
+     * out = a + b, when all have the same size
+     * Without mixed sizes there are no tails to handle; small sizes are unrolled.
+     * `out` may alias `a` or `b`.
+     * @return true if there's overflow
+     */
+    template<std::size_t N>
+    constexpr
+    bool
+    eval_add_fixed(std::array<limb_type, N>& out,
+                   const std::array<limb_type, N>& a,
+                   const std::array<limb_type, N>& b)
+        noexcept
+    {
+        if constexpr (hw::fast_add_n && N > hw::fixed_limbs)
+            return detail::add_n(out.data(), a.data(), b.data(), N);
+
+        wide_limb_type sum = 0;
+        utils::for_each_index<N>([&](std::size_t i)
+        {
+            sum += wide_limb_type{a[i]} + b[i];
+            out[i] = static_cast<limb_type>(sum);
+            sum >>= limb_bits;
+        });
+        return sum;
+    }
+
+
     // a += b
     // returns true if there's overflow
+    constexpr
     bool
     eval_add_inplace(limb_range auto&& a,
                      const limb_range auto& b) noexcept
@@ -70,8 +136,12 @@ namespace xint {
         if (empty(a))
             return is_nonzero(b);
 
-        wide_limb_type sum = 0;
-        for (std::size_t i = 0; i < size(a); ++i) {
+        std::size_t i = std::min(size(a), size(b));
+        wide_limb_type sum = detail::add_n(std::ranges::data(a),
+                                           std::ranges::data(a),
+                                           std::ranges::data(b),
+                                           i);
+        for (; i < size(a); ++i) {
             sum += a[i];
             if (i < size(b))
                 sum += b[i];
@@ -91,6 +161,7 @@ namespace xint {
 
     // a += b (single limb)
     // returns true if there's overflow
+    constexpr
     bool
     eval_add_inplace_limb(limb_range auto&& a,
                           limb_type b) noexcept
@@ -12,6 +12,7 @@
 namespace xint {
 
 
+    constexpr
     bool
     eval_assign(limb_range auto&& a,
                 const limb_range auto& b)
@@ -74,6 +74,7 @@ namespace xint {
     }
 
 
+    constexpr
     void
     eval_bit_op(limb_range auto&& out,
                 const limb_range auto& a,
@@ -90,6 +91,7 @@ namespace xint {
     }
 
 
+    constexpr
     void
     eval_bit_and(limb_range auto&& out,
                  const limb_range auto& a,
@@ -100,6 +102,7 @@ namespace xint {
     }
 
 
+    constexpr
     void
     eval_bit_or(limb_range auto&& out,
                 const limb_range auto& a,
@@ -110,6 +113,7 @@ namespace xint {
     }
 
 
+    constexpr
     void
     eval_bit_xor(limb_range auto&& out,
                  const limb_range auto& a,
@@ -122,6 +126,7 @@ namespace xint {
 
     // TODO: check if overflow logic is correct
     template<bool Check>
+    constexpr
     bool
     eval_bit_shift_left(limb_range auto&& out,
                         const limb_range auto& a,
@@ -174,6 +179,7 @@ namespace xint {
 
 
     template<bool Check>
+    constexpr
     bool
     eval_bit_shift_right(limb_range auto&& out,
                          const limb_range auto& a,
@@ -230,6 +236,87 @@ namespace xint {
     }
 
 
+    /*
+     * out = (a << b) & m, in a single pass
+     * The shift is done in the width of `a`, like eval_bit_shift_left<false>() would.
+     */
+    constexpr
+    void
+    eval_bit_shift_left_and(limb_range auto&& out,
+                            const limb_range auto& a,
+                            unsigned b,
+                            const limb_range auto& m)
+        noexcept
+    {
+        using std::size;
+        const std::size_t limb_offset = b / limb_bits;
+        const unsigned bit_offset = b % limb_bits;
+        const std::size_t n = std::min({size(out), size(a), size(m)});
+
+        std::size_t i = 0;
+        for (; i < n && i < limb_offset; ++i)
+            out[i] = 0;
+        if (i < n) {
+            out[i] = static_cast<limb_type>(a[0] << bit_offset) & m[i];
+            ++i;
+        }
+        if (bit_offset)
+            for (; i < n; ++i) {
+                const std::size_t j = i - limb_offset;
+                const limb_type x = static_cast<limb_type>(a[j] << bit_offset)
+                                  | static_cast<limb_type>(a[j - 1] >> (limb_bits - bit_offset));
+                out[i] = x & m[i];
+            }
+        else
+            for (; i < n; ++i)
+                out[i] = a[i - limb_offset] & m[i];
+        for (; i < size(out); ++i)
+            out[i] = 0;
+    }
+
+
+    /*
+     * out = (a >> b) & m, in a single pass
+     */
+    constexpr
+    void
+    eval_bit_shift_right_and(limb_range auto&& out,
+                             const limb_range auto& a,
+                             unsigned b,
+                             const limb_range auto& m)
+        noexcept
+    {
+        using std::size;
+        const std::size_t limb_offset = b / limb_bits;
+        const unsigned bit_offset = b % limb_bits;
+        const std::size_t avail = size(a) > limb_offset ? size(a) - limb_offset : 0;
+        const std::size_t n = std::min({size(out), avail, size(m)});
+
+        std::size_t i = 0;
+        if (bit_offset) {
+            // all but the last limb can read the next limb of `a` unconditionally
+            for (; i + 1 < n; ++i) {
+                const std::size_t j = i + limb_offset;
+                const limb_type x = static_cast<limb_type>(a[j] >> bit_offset)
+                                  | static_cast<limb_type>(a[j + 1] << (limb_bits - bit_offset));
+                out[i] = x & m[i];
+            }
+            if (i < n) {
+                const std::size_t j = i + limb_offset;
+                limb_type x = static_cast<limb_type>(a[j] >> bit_offset);
+                if (j + 1 < size(a))
+                    x |= static_cast<limb_type>(a[j + 1] << (limb_bits - bit_offset));
+                out[i] = x & m[i];
+                ++i;
+            }
+        } else
+            for (; i < n; ++i)
+                out[i] = a[i + limb_offset] & m[i];
+        for (; i < size(out); ++i)
+            out[i] = 0;
+    }
+
+
     constexpr
     void
     eval_bit_flip(limb_range auto&& out,
@@ -254,6 +341,7 @@ namespace xint {
     }
 
 
+    constexpr
     unsigned
     eval_bit_countl_zero(const limb_range auto& a)
         noexcept
@@ -271,6 +359,7 @@ namespace xint {
     }
 
 
+    constexpr
     unsigned
     eval_bit_countl_one(const limb_range auto& a)
         noexcept
@@ -288,6 +377,7 @@ namespace xint {
     }
 
 
+    constexpr
     unsigned
     eval_bit_countr_zero(const limb_range auto& a)
         noexcept
@@ -305,6 +395,7 @@ namespace xint {
     }
 
 
+    constexpr
     unsigned
     eval_bit_countr_one(const limb_range auto& a)
         noexcept
@@ -359,6 +450,7 @@ namespace xint {
     }
 
 
+    constexpr
     unsigned
     eval_bit_width(const limb_range auto& a)
         noexcept
@@ -12,6 +12,7 @@
 namespace xint {
 
 
+    constexpr
     bool
     eval_compare_equal(const limb_range auto& a,
                        const limb_range auto& b)
@@ -29,6 +30,7 @@ namespace xint {
     }
 
 
+    constexpr
     std::strong_ordering
     eval_compare_three_way(const limb_range auto& a,
                            const limb_range auto& b,
@@ -53,6 +55,7 @@ namespace xint {
     }
 
 
+    constexpr
     std::strong_ordering
     eval_compare_three_way_limb(const limb_range auto& a,
                                 limb_type b,
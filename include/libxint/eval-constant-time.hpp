@@ -0,0 +1,266 @@
+#ifndef XINT_EVAL_CONSTANT_TIME_HPP
+#define XINT_EVAL_CONSTANT_TIME_HPP
+
+#include <algorithm>
+#include <cstddef> // std::size_t
+#include <ranges>
+
+#include "types.hpp"
+
+
+/*
+ * Constant-time kernels.
+ *
+ * None of these functions has a branch or a memory access that depends on the
+ * limb values; the running time only depends on the number of limbs. Conditions are
+ * passed around as masks (all bits set, or all clear) and flags (0 or 1) of type
+ * limb_type, never as bool.
+ */
+
+
+namespace xint::ct {
+
+
+    namespace detail {
+
+        // Hide the value from the optimizer, so it can't turn mask arithmetic back
+        // into branches.
+        inline
+        limb_type
+        barrier(limb_type x)
+            noexcept
+        {
+#if defined(__GNUC__)
+            __asm__("" : "+r"(x));
+#endif
+            return x;
+        }
+
+    } // namespace detail
+
+
+    // all ones if the flag is 1, zero if it's 0
+    inline
+    limb_type
+    mask(limb_type flag)
+        noexcept
+    {
+        return detail::barrier(static_cast<limb_type>(0 - flag));
+    }
+
+
+    /** out = a + b, wrapping around.
+     * @return the carry (0 or 1)
+     */
+    limb_type
+    eval_add(limb_range auto&& out,
+             const limb_range auto& a,
+             const limb_range auto& b)
+        noexcept
+    {
+        using std::size;
+        wide_limb_type sum = 0;
+        for (std::size_t i = 0; i < size(out); ++i) {
+            if (i < size(a))
+                sum += a[i];
+            if (i < size(b))
+                sum += b[i];
+            out[i] = static_cast<limb_type>(sum);
+            sum >>= limb_bits;
+        }
+        return static_cast<limb_type>(sum);
+    }
+
+
+    /** out = a - b, wrapping around.
+     * @return the borrow (0 or 1)
+     */
+    limb_type
+    eval_sub(limb_range auto&& out,
+             const limb_range auto& a,
+             const limb_range auto& b)
+        noexcept
+    {
+        using std::size;
+        wide_limb_type borrow = 0;
+        for (std::size_t i = 0; i < size(out); ++i) {
+            wide_limb_type d = 0;
+            if (i < size(a))
+                d = a[i];
+            if (i < size(b))
+                d -= b[i];
+            d -= borrow;
+            out[i] = static_cast<limb_type>(d);
+            borrow = (d >> limb_bits) & 1;
+        }
+        return static_cast<limb_type>(borrow);
+    }
+
+
+    /** Compare a < b.
+     * @return 1 if a < b, 0 otherwise
+     */
+    limb_type
+    eval_less(const limb_range auto& a,
+              const limb_range auto& b)
+        noexcept
+    {
+        using std::size;
+        const std::size_t n = std::max<std::size_t>(size(a), size(b));
+        wide_limb_type borrow = 0;
+        for (std::size_t i = 0; i < n; ++i) {
+            wide_limb_type d = 0;
+            if (i < size(a))
+                d = a[i];
+            if (i < size(b))
+                d -= b[i];
+            d -= borrow;
+            borrow = (d >> limb_bits) & 1;
+        }
+        return static_cast<limb_type>(borrow);
+    }
+
+
+    /** Test a == 0.
+     * @return 1 if all limbs are zero, 0 otherwise
+     */
+    limb_type
+    eval_is_zero(const limb_range auto& a)
+        noexcept
+    {
+        limb_type acc = 0;
+        for (auto x : a)
+            acc |= x;
+        // the top bit of (acc | -acc) is set only if acc is nonzero
+        const limb_type nonzero = static_cast<limb_type>(acc | (0 - acc)) >> (limb_bits - 1);
+        return nonzero ^ 1;
+    }
+
+
+    /** Compare a == b.
+     * @return 1 if a == b, 0 otherwise
+     */
+    limb_type
+    eval_equal(const limb_range auto& a,
+               const limb_range auto& b)
+        noexcept
+    {
+        using std::size;
+        const std::size_t n = std::max<std::size_t>(size(a), size(b));
+        limb_type acc = 0;
+        for (std::size_t i = 0; i < n; ++i) {
+            limb_type x = 0;
+            if (i < size(a))
+                x = a[i];
+            if (i < size(b))
+                x ^= b[i];
+            acc |= x;
+        }
+        const limb_type nonzero = static_cast<limb_type>(acc | (0 - acc)) >> (limb_bits - 1);
+        return nonzero ^ 1;
+    }
+
+
+    /** out = m ? a : b
+     * `m` must be a mask.
+     */
+    void
+    eval_select(limb_range auto&& out,
+                limb_type m,
+                const limb_range auto& a,
+                const limb_range auto& b)
+        noexcept
+    {
+        using std::size;
+        for (std::size_t i = 0; i < size(out); ++i) {
+            const limb_type x = i < size(a) ? a[i] : 0;
+            const limb_type y = i < size(b) ? b[i] : 0;
+            out[i] = static_cast<limb_type>((x & m) | (y & ~m));
+        }
+    }
+
+
+    /** Swap a and b if m is set.
+     * `m` must be a mask. `a` and `b` must have the same size.
+     */
+    void
+    eval_cswap(limb_type m,
+               limb_range auto&& a,
+               limb_range auto&& b)
+        noexcept
+    {
+        using std::size;
+        for (std::size_t i = 0; i < size(a); ++i) {
+            const limb_type d = static_cast<limb_type>((a[i] ^ b[i]) & m);
+            a[i] ^= d;
+            b[i] ^= d;
+        }
+    }
+
+
+    /** Restoring binary division: q = a / b, r = a % b
+     *
+     * Always runs one iteration per bit of `a`, each doing one subtraction and one
+     * masked addition over n + 1 limbs, where n is the size of `b`.
+     *
+     *     - `q` must have at least as many limbs as `a`.
+     *     - `r` must have at least as many limbs as `b`.
+     *     - `t` is scratch space with n + 1 limbs.
+     *     - `b` must not be zero; this is not checked.
+     */
+    void
+    eval_div(limb_range auto&& q,
+             limb_range auto&& r,
+             const limb_range auto& a,
+             const limb_range auto& b,
+             limb_range auto&& t)
+        noexcept
+    {
+        using std::size;
+        const std::size_t n = size(b);
+
+        std::ranges::fill(q, 0);
+        std::ranges::fill(t, 0);
+
+        for (std::size_t i = size(a) * limb_bits; i-- > 0;) {
+            // t = (t << 1) | bit i of a
+            limb_type in = (a[i / limb_bits] >> (i % limb_bits)) & 1;
+            for (std::size_t j = 0; j <= n; ++j) {
+                const limb_type out = t[j] >> (limb_bits - 1);
+                t[j] = static_cast<limb_type>((t[j] << 1) | in);
+                in = out;
+            }
+
+            // t -= b, then add b back if it borrowed
+            wide_limb_type borrow = 0;
+            for (std::size_t j = 0; j <= n; ++j) {
+                wide_limb_type d = t[j];
+                if (j < n)
+                    d -= b[j];
+                d -= borrow;
+                t[j] = static_cast<limb_type>(d);
+                borrow = (d >> limb_bits) & 1;
+            }
+            const limb_type m = mask(static_cast<limb_type>(borrow));
+            wide_limb_type sum = 0;
+            for (std::size_t j = 0; j <= n; ++j) {
+                sum += t[j];
+                if (j < n)
+                    sum += static_cast<limb_type>(b[j] & m);
+                t[j] = static_cast<limb_type>(sum);
+                sum >>= limb_bits;
+            }
+
+            q[i / limb_bits] |= static_cast<limb_type>((borrow ^ 1) << (i % limb_bits));
+        }
+
+        std::ranges::fill(r, 0);
+        std::ranges::copy(t | std::views::take(std::min<std::size_t>(n, size(r))),
+                          std::ranges::begin(r));
+    }
+
+
+} // namespace xint::ct
+
+
+#endif
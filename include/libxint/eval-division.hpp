@@ -30,10 +30,15 @@ namespace xint {
 
     /* Notes:
      *     - `q`, `r` are the output.
-     *     - `a` and `r` are modified as part of the calculation.
+     *     - `a` and `b` may be modified as part of the calculation.
      *     - `q` must be at least as large as `a` to avoid overflow.
-     *     - `r` must have one mre limb than `b`.
+     *     - `r` must have one more limb than `b`.
+     *
+     * This is Knuth's Algorithm D (TAOCP vol. 2, 4.3.1): `b` is normalized so its top
+     * bit is set, and each quotient limb is estimated from the top limbs of the
+     * partial remainder, which lives in `r`.
      */
+    constexpr
     div_status
     eval_div(limb_range auto&& q,
              limb_range auto&& r,
@@ -42,7 +47,6 @@ namespace xint {
         noexcept
     {
         using std::size;
-        using std::views::drop;
         using std::views::take;
 
         const unsigned b_width = eval_bit_width(b);
@@ -77,53 +81,91 @@ namespace xint {
             return div_status::success;
         }
 
-        // first, line-up top bit of b with top bit of a
-        auto bit_offset = [](unsigned s) -> unsigned { return s % limb_bits; };
-        auto limb_offset = [](unsigned s) -> unsigned { return s / limb_bits; };
-
-        unsigned a_width = eval_bit_width(a);
-        unsigned shift;
+        // number of significant limbs in a and b
+        const std::size_t n = (b_width - 1) / limb_bits + 1;
+        const std::size_t a_len = (eval_bit_width(a) - 1) / limb_bits + 1;
+        assert(a_len >= n);
+
+        // normalize b, so its top bit is set; it's restored at the end
+        const unsigned norm = (limb_bits - b_width % limb_bits) % limb_bits;
+        eval_bit_shift_left<false>(b, b, norm);
+
+        // limb j of the normalized a, which has a_len + 1 limbs
+        auto u = [&a, a_len, norm](std::size_t j) -> limb_type
+        {
+            wide_limb_type v = j < a_len ? a[j] : 0;
+            v <<= norm;
+            if (j > 0 && norm)
+                v |= static_cast<wide_limb_type>(a[j - 1]) >> (limb_bits - norm);
+            return static_cast<limb_type>(v);
+        };
+
+        const wide_limb_type base = wide_limb_type{1} << limb_bits;
+        const wide_limb_type b_top = b[n - 1];
+        const wide_limb_type b_next = n >= 2 ? b[n - 2] : 0;
+
+        // the partial remainder, starts with the top n limbs of u, which are less than b
+        auto rem = r | take(n + 1);
+        std::ranges::fill(r, 0);
+        for (std::size_t i = 0; i < n; ++i)
+            rem[i] = u(a_len + 1 - n + i);
 
         div_status status = div_status::success;
 
-        do {
-            shift = a_width - b_width;
-            // note: we set `r = b << shift` so we don't modify b
-            // r is guaranteed to have one more limb than b, so it never overflows
-            eval_bit_shift_left<false>(r, b, bit_offset(shift));
-
-            if (eval_sub_inplace(a | drop(limb_offset(shift)), r)) {
-                // we subtracted too much, try to make b smaller
-                if (!shift) {
-                    // if can't make b smaller, just rollback the subtraction,
-                    // and break the loop
-                    eval_add_inplace(a | drop(limb_offset(shift)), r);
+        for (std::size_t j = a_len + 1 - n; j-- > 0;) {
+            // rem = rem * base + u(j)
+            for (std::size_t i = n; i > 0; --i)
+                rem[i] = rem[i - 1];
+            rem[0] = u(j);
+
+            // estimate the quotient limb from the top limbs, it's never too small
+            const wide_limb_type top2 = static_cast<wide_limb_type>(rem[n]) << limb_bits
+                                        | rem[n - 1];
+            wide_limb_type qhat = top2 / b_top;
+            wide_limb_type rhat = top2 % b_top;
+            const wide_limb_type rem_next = n >= 2 ? rem[n - 2] : 0;
+            while (qhat >= base
+                   || (n >= 2 && qhat * b_next > (rhat << limb_bits | rem_next))) {
+                --qhat;
+                rhat += b_top;
+                if (rhat >= base)
                     break;
-                }
-                --shift;
-                eval_bit_shift_left<false>(r, b, bit_offset(shift));
-                eval_add_inplace(a | drop(limb_offset(shift)), r);
             }
-            // we can avoid looking at limbs known to be zero
-            a_width = eval_bit_width(a | take(limb_offset(a_width - 1) + 1));
-
-            /*
-             * This is a more efficient version of
-             *     q += uint<Bits>(1) << shift;
-             */
-            const limb_type x = static_cast<limb_type>(1) << bit_offset(shift);
-            if (eval_add_inplace_limb(q | drop(limb_offset(shift)), x))
-                status = div_status::overflow;
 
-        } while (shift && a_width >= b_width);
+            // rem -= qhat * b
+            wide_limb_type carry = 0;
+            wide_limb_type borrow = 0;
+            for (std::size_t i = 0; i < n; ++i) {
+                carry += qhat * b[i];
+                const wide_limb_type d = rem[i] - (carry & (base - 1)) - borrow;
+                rem[i] = static_cast<limb_type>(d);
+                borrow = (d >> limb_bits) & 1;
+                carry >>= limb_bits;
+            }
+            const wide_limb_type d = rem[n] - carry - borrow;
+            rem[n] = static_cast<limb_type>(d);
+
+            // rarely, qhat is still one too large: add b back
+            if ((d >> limb_bits) & 1) {
+                --qhat;
+                eval_add_inplace(rem, b | take(n));
+            }
 
-        if (eval_assign(r, a))
-            status = div_status::overflow;
+            if (j < size(q))
+                q[j] = static_cast<limb_type>(qhat);
+            else if (qhat)
+                status = div_status::overflow;
+        }
+
+        // undo the normalization
+        eval_bit_shift_right<false>(r, rem, norm);
+        eval_bit_shift_right<false>(b, b, norm);
 
         return status;
     }
 
 
+    constexpr
     div_status
     eval_div_limb(limb_range auto&& q,
                   limb_type& r,
@@ -202,6 +244,32 @@ namespace xint {
         return status;
     }
 
+
+    /*
+     * a /= b (single limb)
+     * This is the plain long division, one limb at a time from the top.
+     * `b` must not be zero.
+     * @return the remainder
+     */
+    constexpr
+    limb_type
+    eval_div_inplace_limb(limb_range auto&& a,
+                          limb_type b)
+        noexcept
+    {
+        using std::size;
+
+        assert(b != 0);
+
+        wide_limb_type rem = 0;
+        for (std::size_t i = size(a); i-- > 0;) {
+            rem = rem << limb_bits | a[i];
+            a[i] = static_cast<limb_type>(rem / b);
+            rem %= b;
+        }
+        return static_cast<limb_type>(rem);
+    }
+
 }
 
 
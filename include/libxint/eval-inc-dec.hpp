@@ -12,6 +12,7 @@
 namespace xint {
 
 
+    constexpr
     bool
     eval_increment(limb_range auto&& a,
                    limb_range auto&& old)
@@ -30,6 +31,7 @@ namespace xint {
     }
 
 
+    constexpr
     bool
     eval_increment(limb_range auto&& a)
         noexcept
@@ -41,6 +43,7 @@ namespace xint {
     }
 
 
+    constexpr
     bool
     eval_decrement(limb_range auto&& a,
                    limb_range auto& old)
@@ -59,6 +62,7 @@ namespace xint {
     }
 
 
+    constexpr
     bool
     eval_decrement(limb_range auto&& a)
         noexcept
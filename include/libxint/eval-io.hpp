@@ -1,110 +1,172 @@
 #ifndef XINT_EVAL_IO_HPP
 #define XINT_EVAL_IO_HPP
 
-#include <iomanip>
+#include <algorithm> // copy(), fill()
+#include <bit>
+#include <cstddef> // std::size_t
 #include <ios>
 #include <istream>
-#include <locale>
+#include <iterator> // size()
 #include <ostream>
+#include <streambuf>
 
-#include "uint.hpp"
+#include "eval-radix.hpp"
 #include "traits.hpp"
+#include "uint.hpp"
 
 
 namespace xint {
 
 
-    void
-    eval_input_hex(std::istream& in,
-                   unsigned_integral auto& n)
-    {
-        using std::toupper;
-        using std::isxdigit;
-        const auto eof = std::istream::traits_type::eof();
-        char c;
-        if (!(in >> c))
-            return;
-        n = 0;
-        const auto loc = in.getloc();
-        if (c == '0') { // might be a prefix
-            auto next = in.peek();
-            if (next == eof)
-                return;
-            if (toupper(next, loc) == 'X') { // we got '0x'
-                next = in.get(); // extract the 'x'
-                auto next2 = in.peek();
-                if (next2 == eof || !isxdigit(next2, loc)) {
-                    // nothing to read after '0x'
-                    in.unget(); // put the 'x' back
-                    return; // extracted only the '0', n was initialized to zero.
-                } // otherwise keep going; '0x' was extracted
-            } else
-                // not 0x
-                in.unget(); // put the '0' back
-        } else // c was not '0'
-            in.unget(); // put c back
-
-        // at this point, if there was a prefix, it's been extracted
-        // we will consume all hex digits until they stop
-        auto getxdigit = [&in, &loc, eof](char& c) -> bool
-        {
-            auto p = in.peek();
-            if (p == eof)
-                return false;
-            if (!isxdigit(p, loc))
-                return false;
-            in.get(c);
-            return true;
-        };
-
-        bool overflow = false;
-        bool consumed = false;
-        while (getxdigit(c)) {
-            consumed = true;
-            limb_type value = std::stoul(std::string(1, c), nullptr, 16);
-            if (eval_bit_shit_left<true>(n.limbs(), n.limbs(), 4))
-                overflow = true;
-            n |= value;
-        }
-        if (!consumed || overflow)
-            in.setstate(std::ios_base::failbit);
-    }
-
-
+    /*
+     * Reads a number straight from the stream buffer, like std::num_get does for the
+     * built-in unsigned types: the base comes from the basefield flags, and when it's not
+     * set, from the prefix ("0x", "0b", "0o" or "0"). With std::hex and std::oct the "0x"
+     * and "0o" prefixes are optional.
+     *
+     * The digits are gathered in a limb, and folded into n once per limb; for powers of 2
+     * the limbs are just stored.
+     * When there are no digits, n is set to zero; on overflow, n is set to the maximum
+     * value. In both cases failbit is set.
+     */
     template<unsigned_integral U>
     void
     eval_input(std::istream& in,
                U& n)
     {
-        auto base = in.flags() & std::ios_base::basefield;
-        switch (base) {
+        using traits = std::istream::traits_type;
+
+        std::streambuf* sb = in.rdbuf();
+        std::ios_base::iostate state = std::ios_base::goodbit;
+
+        unsigned base = 0;
+        switch (in.flags() & std::ios_base::basefield) {
             case std::ios_base::hex:
-                eval_input_hex(in, n);
+                base = 16;
                 break;
             case std::ios_base::oct:
-                {
-                    // TODO
-                    std::string arg;
-                    in >> arg;
-                    n = U{arg, 8};
-                }
+                base = 8;
                 break;
             case std::ios_base::dec:
-                {
-                    // TODO
-                    std::string arg;
-                    in >> arg;
-                    n = U{arg, 10};
-                }
+                base = 10;
                 break;
-            default:
-                {
-                    // TODO
-                    std::string arg;
-                    in >> arg;
-                    n = U{arg};
+        }
+
+        auto lower = [](traits::int_type c) -> traits::int_type
+        {
+            return c >= 'A' && c <= 'Z' ? c - 'A' + 'a' : c;
+        };
+        auto digit = [&base](traits::int_type c) -> unsigned
+        {
+            if (traits::eq_int_type(c, traits::eof()))
+                return 0xff;
+            const unsigned d = detail::digit_value(traits::to_char_type(c));
+            return d < base ? d : 0xff;
+        };
+
+        bool any = false;
+        traits::int_type c = sb->sgetc();
+
+        if (base != 10 && traits::eq_int_type(c, '0')) {
+            any = true;
+            c = sb->snextc();
+            unsigned prefix_base = 0;
+            switch (lower(c)) {
+                case 'x':
+                    prefix_base = 16;
+                    break;
+                case 'b':
+                    prefix_base = 2;
+                    break;
+                case 'o':
+                    prefix_base = 8;
+                    break;
+            }
+            if (prefix_base && (!base || base == prefix_base)) {
+                const unsigned old_base = base;
+                base = prefix_base;
+                c = sb->snextc();
+                if (digit(c) == 0xff) {
+                    // just a zero, followed by a letter
+                    base = old_base;
+                    if (!traits::eq_int_type(sb->sungetc(), traits::eof()))
+                        c = sb->sgetc();
                 }
+            }
+            if (!base) // a leading zero means octal
+                base = 8;
+        }
+        if (!base)
+            base = 10;
+
+        bool overflow = false;
+        std::ranges::fill(n.limbs(), 0);
+
+        if (std::has_single_bit(base)) {
+            /*
+             * Each digit is a group of bits: full limbs are stored from the top down as
+             * they come, and moved into place at the end.
+             */
+            auto&& a = n.limbs();
+            const unsigned shift = std::bit_width(base) - 1;
+            std::size_t top = std::size(a); // a[top, size) has the limbs read so far
+            std::size_t bits = 0; // significant bits read, leading zeros don't count
+            wide_limb_type acc = 0;
+            unsigned acc_bits = 0;
+            for (unsigned d; (d = digit(c)) != 0xff; c = sb->snextc()) {
+                any = true;
+                const unsigned w = bits ? shift : static_cast<unsigned>(std::bit_width(d));
+                bits += w;
+                if (bits > U::num_bits) {
+                    overflow = true;
+                    continue;
+                }
+                acc = static_cast<wide_limb_type>(acc << w | d);
+                acc_bits += w;
+                if (acc_bits >= limb_bits) {
+                    acc_bits -= limb_bits;
+                    a[--top] = static_cast<limb_type>(acc >> acc_bits);
+                    acc &= (wide_limb_type{1} << acc_bits) - 1;
+                }
+            }
+            if (!overflow && top != std::size(a)) {
+                std::copy(a.begin() + top, a.end(), a.begin());
+                std::fill(a.end() - top, a.end(), 0);
+                eval_bit_shift_left<false>(a, a, acc_bits);
+            }
+            a[0] |= static_cast<limb_type>(acc);
+        } else {
+            const detail::radix_chunk chunk = detail::make_radix_chunk(base);
+            std::size_t len = 0;
+            limb_type acc = 0;
+            limb_type power = 1;
+            unsigned count = 0;
+            for (unsigned d; (d = digit(c)) != 0xff; c = sb->snextc()) {
+                any = true;
+                acc = static_cast<limb_type>(acc * base + d);
+                power = static_cast<limb_type>(power * base);
+                if (++count == chunk.digits) {
+                    if (!overflow)
+                        overflow = !detail::mul_add_chunk(n.limbs(), len, power, acc);
+                    acc = 0;
+                    power = 1;
+                    count = 0;
+                }
+            }
+            if (count && !overflow)
+                overflow = !detail::mul_add_chunk(n.limbs(), len, power, acc);
+        }
+
+        if (traits::eq_int_type(c, traits::eof()))
+            state |= std::ios_base::eofbit;
+        if (!any) {
+            std::ranges::fill(n.limbs(), 0);
+            state |= std::ios_base::failbit;
+        } else if (overflow) {
+            std::ranges::fill(n.limbs(), ~limb_type{0});
+            state |= std::ios_base::failbit;
         }
+        in.setstate(state);
     }
 
 
@@ -0,0 +1,103 @@
+#ifndef XINT_EVAL_MONTGOMERY_HPP
+#define XINT_EVAL_MONTGOMERY_HPP
+
+#include <algorithm>
+#include <cassert>
+#include <ranges>
+
+#include "dispatch.hpp"
+#include "types.hpp"
+#include "utils.hpp"
+
+#include "eval-comparison.hpp"
+#include "eval-constant-time.hpp"
+#include "eval-subtraction.hpp"
+
+
+namespace xint {
+
+
+    // -m^-1 mod 2^limb_bits, m must be odd
+    constexpr
+    limb_type
+    eval_mont_inverse(limb_type m0)
+        noexcept
+    {
+        assert(m0 & 1);
+        // Newton's iteration, each step doubles the number of correct bits
+        // note: m0 * m0 == 1 (mod 8) when m0 is odd, so it starts with 3 correct bits
+        limb_type x = m0;
+        for (unsigned bits = 3; bits < limb_bits; bits *= 2)
+            x = static_cast<limb_type>(x * static_cast<limb_type>(2 - m0 * x));
+        return static_cast<limb_type>(-x);
+    }
+
+
+    /*
+     * out = a * b / R (mod m), where R = 2^(limb_bits * n)
+     * This is the Coarsely Integrated Operand Scanning (CIOS) method, done by
+     * hw::mont_mul(), so it uses the backend picked in dispatch.hpp.
+     * Notes:
+     *     - `a`, `b`, `m` and `out` must have n limbs.
+     *     - `m` must be odd, `m_inv` is eval_mont_inverse(m[0]).
+     *     - `t` is scratch space with 2n + 1 limbs.
+     *     - `a` must be less than m, `b` must be less than R. The result is less than m.
+     *     - `out` may alias `a` or `b`.
+     *     - When `ConstantTime` is true, the final subtraction doesn't depend on the
+     *       values, so the running time doesn't either.
+     */
+    template<bool ConstantTime = false>
+    void
+    eval_mont_mul(limb_range auto&& out,
+                  const limb_range auto& a,
+                  const limb_range auto& b,
+                  const limb_range auto& m,
+                  limb_type m_inv,
+                  limb_range auto&& t)
+        noexcept
+    {
+        using std::size;
+
+        const std::size_t n = size(m);
+        assert(size(a) == n);
+        assert(size(b) == n);
+        assert(size(out) == n);
+        assert(size(t) >= 2 * n + 1);
+
+        hw::mont_mul(std::ranges::data(t),
+                     std::ranges::data(a),
+                     std::ranges::data(b),
+                     std::ranges::data(m),
+                     m_inv,
+                     n);
+
+        // tn < 2m, a single subtraction is enough
+        auto tn = t | std::views::drop(n) | std::views::take(n + 1);
+        if constexpr (ConstantTime) {
+            // always subtract, then add m back, masked by the borrow
+            wide_limb_type borrow = 0;
+            for (std::size_t j = 0; j <= n; ++j) {
+                const wide_limb_type mj = j < n ? m[j] : 0;
+                const wide_limb_type d = tn[j] - mj - borrow;
+                tn[j] = static_cast<limb_type>(d);
+                borrow = (d >> limb_bits) & 1;
+            }
+            const limb_type mask = ct::mask(static_cast<limb_type>(borrow));
+            wide_limb_type c = 0;
+            for (std::size_t j = 0; j < n; ++j) {
+                c += tn[j];
+                c += static_cast<limb_type>(m[j] & mask);
+                tn[j] = static_cast<limb_type>(c);
+                c >>= limb_bits;
+            }
+        } else {
+            if (eval_compare_three_way(tn, m) >= 0)
+                eval_sub_inplace(tn, m);
+        }
+        std::ranges::copy(tn | std::views::take(n), std::ranges::begin(out));
+    }
+
+}
+
+
+#endif
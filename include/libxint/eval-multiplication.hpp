@@ -2,18 +2,70 @@
 #define XINT_EVAL_MULTIPLICATION_HPP
 
 #include <algorithm>
+#include <array>
 #include <cassert>
+#include <cstddef> // std::size_t
 #include <limits>
 #include <ranges>
+#include <span>
+#include <type_traits> // is_constant_evaluated()
 
-#include "eval-addition.hpp"
+#include "dispatch.hpp"
+#include "types.hpp"
 #include "utils.hpp"
 
+#include "eval-addition.hpp"
+#include "eval-assignment.hpp"
+#include "eval-subtraction.hpp"
+
 
 namespace xint {
 
 
+    namespace detail {
+
+        /*
+         * out[0, n) = a[0, n) * b
+         * `out` may alias `a`.
+         * @return the high limb
+         */
+        constexpr
+        limb_type
+        mul_1(limb_type* out,
+              const limb_type* a,
+              std::size_t n,
+              limb_type b)
+            noexcept
+        {
+            if (std::is_constant_evaluated())
+                return hw::portable::mul_1(out, a, n, b);
+            return hw::mul_1(out, a, n, b);
+        }
+
+
+        /*
+         * out[0, n) += a[0, n) * b
+         * `out` must not overlap `a`.
+         * @return the limb carried out of out[n - 1]
+         */
+        constexpr
+        limb_type
+        addmul_1(limb_type* out,
+                 const limb_type* a,
+                 std::size_t n,
+                 limb_type b)
+            noexcept
+        {
+            if (std::is_constant_evaluated())
+                return hw::portable::addmul_1(out, a, n, b);
+            return hw::addmul_1(out, a, n, b);
+        }
+
+    } // namespace detail
+
+
     // a *= b (single limb)
+    constexpr
     bool
     eval_mul_inplace_limb(limb_range auto&& a,
                           limb_type b)
@@ -26,17 +78,13 @@ namespace xint {
         if (utils::is_zero(a))
             return false;
 
-        wide_limb_type sum = 0;
-        for (auto& ai : a) {
-            sum += ai * wide_limb_type{b};
-            ai = static_cast<limb_type>(sum);
-            sum >>= limb_bits;
-        }
-        return sum;
+        const auto p = std::ranges::data(a);
+        return detail::mul_1(p, p, std::ranges::size(a), b);
     }
 
 
     // out = a * b (single limb)
+    constexpr
     bool
     eval_mul_limb(limb_range auto&& out,
                   const limb_range auto& a,
@@ -55,14 +103,15 @@ namespace xint {
             return false;
         }
 
-        wide_limb_type sum = 0;
-        for (std::size_t i = 0; i < size(out); ++i) {
-            if (i < size(a))
-                sum += a[i] * wide_limb_type{b};
-            out[i] = static_cast<limb_type>(sum);
-            sum >>= limb_bits;
-        }
-        if (sum)
+        const std::size_t n = std::min(size(out), size(a));
+        const limb_type hi = detail::mul_1(std::ranges::data(out),
+                                           std::ranges::data(a),
+                                           n,
+                                           b);
+        if (n < size(out)) {
+            out[n] = hi;
+            std::ranges::fill(out | std::views::drop(n + 1), 0);
+        } else if (hi)
             return true;
 
         // if a is longer than out, any non-zero unused limb will imply an overflow
@@ -74,13 +123,19 @@ namespace xint {
     }
 
 
-    // out = a * b
+    /*
+     * out = a * b
+     * This is the schoolbook method, done one row (one limb of `a`) at a time, so the
+     * carry is propagated only once per row. Only the limbs that fit in `out` are
+     * computed, so a same-width multiplication only does half of the work.
+     * @return true if there's overflow
+     */
+    constexpr
     bool
     eval_mul_simple(limb_range auto&& out,
                     const limb_range auto& a,
                     const limb_range auto& b) noexcept
     {
-        using std::views::drop;
         using std::size;
 
         assert(&a[0] != &out[0]);
@@ -91,35 +146,549 @@ namespace xint {
         if (utils::is_zero(a) || utils::is_zero(b))
             return false;
 
+        const std::size_t a_rows = std::min(size(a), size(out));
         bool overflow = false;
-        for (std::size_t i = 0; i < size(out); ++i) {
-            for (std::size_t j = 0; j <= i; ++j) {
-                wide_limb_type x = j < size(a) ? a[j] : 0;
-                wide_limb_type y = i - j < size(b) ? b[i - j] : 0;
-                wide_limb_type prod = x * y;
-                limb_type prod_lo = static_cast<limb_type>(prod);
-                limb_type prod_hi = static_cast<limb_type>(prod >> limb_bits);
-                if (eval_add_inplace_limb(out | drop(i), prod_lo))
-                    overflow = true;
-                if (eval_add_inplace_limb(out | drop(i + 1), prod_hi))
+        for (std::size_t i = 0; i < a_rows; ++i) {
+            if (!a[i])
+                continue;
+            // only the columns that fit in out
+            const std::size_t b_cols = std::min(size(b), size(out) - i);
+            const limb_type carry = detail::addmul_1(std::ranges::data(out) + i,
+                                                     std::ranges::data(b),
+                                                     b_cols,
+                                                     a[i]);
+            if (carry) {
+                // out[i + b_cols] was never written by the previous rows
+                if (i + b_cols < size(out))
+                    out[i + b_cols] = static_cast<limb_type>(carry);
+                else
                     overflow = true;
             }
         }
         if (overflow)
             return true;
 
-        // if either `a` or `b` are longer than `out`, check if the unused limbs are non-zero
-        if (size(a) > size(out)
-            && utils::is_nonzero(a | drop(size(out))))
-            return true;
-        if (size(b) > size(out)
-            && utils::is_nonzero(b | drop(size(out))))
+        /*
+         * Partial products that land entirely beyond `out` are never computed above,
+         * so check them through the top non-zero limbs of `a` and `b`. This also
+         * covers the case where `a` or `b` are longer than `out`.
+         */
+        auto top_limb = [](const auto& r) -> std::size_t
+        {
+            std::size_t i = size(r) - 1;
+            while (!r[i])
+                --i;
+            return i;
+        };
+        if (top_limb(a) + top_limb(b) >= size(out))
             return true;
 
         return false;
     }
 
 
+    // out = a * b (single limb), when out and a have the same size; out may alias a
+    template<std::size_t N>
+    constexpr
+    bool
+    eval_mul_limb_fixed(std::array<limb_type, N>& out,
+                        const std::array<limb_type, N>& a,
+                        limb_type b)
+        noexcept
+    {
+        if constexpr (hw::fast_mul_1 && N > hw::fixed_limbs)
+            return detail::mul_1(out.data(), a.data(), N, b);
+
+        wide_limb_type carry = 0;
+        utils::for_each_index<N>([&](std::size_t i)
+        {
+            carry += a[i] * wide_limb_type{b};
+            out[i] = static_cast<limb_type>(carry);
+            carry >>= limb_bits;
+        });
+        return carry;
+    }
+
+
+    /*
+     * out = a * b, when all have the same size, up to utils::unroll_limbs limbs
+     * Same method as eval_mul_simple(), but every row and column is unrolled, and there's
+     * no test for zero limbs.
+     * Notes:
+     *     - `out` must not alias `a` or `b`.
+     * @return true if there's overflow
+     */
+    template<std::size_t N>
+    requires (N <= utils::unroll_limbs)
+    constexpr
+    bool
+    eval_mul_fixed(std::array<limb_type, N>& out,
+                   const std::array<limb_type, N>& a,
+                   const std::array<limb_type, N>& b)
+        noexcept
+    {
+        out.fill(0);
+
+        bool overflow = false;
+        if constexpr (hw::fast_mul_1 && N > hw::fixed_limbs) {
+            for (std::size_t i = 0; i < N; ++i)
+                overflow |= detail::addmul_1(out.data() + i, b.data(), N - i, a[i]) != 0;
+        } else
+            utils::for_each_index<N>([&](auto i)
+            {
+                const wide_limb_type ai = a[i];
+                wide_limb_type carry = 0;
+                // only the columns that fit in out
+                utils::for_each_index<N - decltype(i)::value>([&](std::size_t j)
+                {
+                    carry += ai * b[j] + out[i + j];
+                    out[i + j] = static_cast<limb_type>(carry);
+                    carry >>= limb_bits;
+                });
+                overflow |= carry != 0;
+            });
+
+        // the partial products beyond out, through the number of significant limbs
+        std::size_t a_len = 0;
+        std::size_t b_len = 0;
+        utils::for_each_index<N>([&](std::size_t i)
+        {
+            if (a[i])
+                a_len = i + 1;
+            if (b[i])
+                b_len = i + 1;
+        });
+        return overflow || (a_len && b_len && a_len + b_len > N + 1);
+    }
+
+
+    /*
+     * out = a * b + c
+     * Same row-wise method as eval_mul_simple(), but the rows are accumulated on top of
+     * `c` instead of zero, so the addition costs no extra pass.
+     * Notes:
+     *     - `out` must not alias `a` or `b`; it may alias `c`.
+     * @return true if there's overflow
+     */
+    constexpr
+    bool
+    eval_mul_add(limb_range auto&& out,
+                 const limb_range auto& a,
+                 const limb_range auto& b,
+                 const limb_range auto& c) noexcept
+    {
+        using std::size;
+
+        assert(&a[0] != &out[0]);
+        assert(&b[0] != &out[0]);
+
+        bool overflow = eval_assign(out, c);
+
+        if (utils::is_zero(a) || utils::is_zero(b))
+            return overflow;
+
+        // top non-zero limb of b: partial products from column i + b_top on
+        std::size_t b_top = size(b) - 1;
+        while (!b[b_top])
+            --b_top;
+
+        for (std::size_t i = 0; i < size(a); ++i) {
+            if (!a[i])
+                continue;
+            if (i >= size(out)) {
+                overflow = true;
+                break;
+            }
+            if (i + b_top >= size(out))
+                overflow = true;
+            const std::size_t b_cols = std::min(b_top + 1, size(out) - i);
+            wide_limb_type carry = detail::addmul_1(std::ranges::data(out) + i,
+                                                    std::ranges::data(b),
+                                                    b_cols,
+                                                    a[i]);
+            // c may have set the upper limbs, so the carry can go further
+            for (std::size_t k = i + b_cols; carry && k < size(out); ++k) {
+                carry += out[k];
+                out[k] = static_cast<limb_type>(carry);
+                carry >>= limb_bits;
+            }
+            if (carry)
+                overflow = true;
+        }
+
+        return overflow;
+    }
+
+
+    namespace detail {
+
+        /*
+         * t = the columns of a * b from `c` up, as if the partial products that land
+         * below column c were zero. Columns below c are left untouched.
+         */
+        constexpr
+        void
+        mul_columns_from(limb_range auto&& t,
+                         const limb_range auto& a,
+                         const limb_range auto& b,
+                         std::size_t c)
+            noexcept
+        {
+            using std::size;
+
+            std::ranges::fill(t | std::views::drop(c), 0);
+
+            for (std::size_t i = 0; i < size(a); ++i) {
+                const std::size_t j0 = c > i ? c - i : 0;
+                if (!a[i] || j0 >= size(b))
+                    continue;
+                // t[i + size(b)] was never written by the previous rows
+                t[i + size(b)] = detail::addmul_1(std::ranges::data(t) + i + j0,
+                                                  std::ranges::data(b) + j0,
+                                                  size(b) - j0,
+                                                  a[i]);
+            }
+        }
+
+    } // namespace detail
+
+
+    /*
+     * out = (a * b) >> (n * limb_bits), where n is the size of the longer operand
+     *
+     * Only the partial products from column n - 3 up are computed, about half of the
+     * full product. The ones that are skipped add less than one unit to column n - 1,
+     * so the result is exact unless that column is all ones; in that unlikely case the
+     * full product is computed.
+     * Notes:
+     *     - `t` is scratch space with size(a) + size(b) limbs.
+     *     - `out` should have at least min(size(a), size(b)) limbs.
+     */
+    constexpr
+    void
+    eval_mul_hi(limb_range auto&& out,
+                const limb_range auto& a,
+                const limb_range auto& b,
+                limb_range auto&& t)
+        noexcept
+    {
+        using std::size;
+
+        if (utils::is_zero(a) || utils::is_zero(b)) {
+            std::ranges::fill(out, 0);
+            return;
+        }
+
+        const std::size_t n = std::max(size(a), size(b));
+        assert(size(t) >= size(a) + size(b));
+
+        /*
+         * The skipped partial products add up to less than c * 2^((c + 1) * limb_bits),
+         * so this only works while c fits in a limb (a concern for 8-bit limbs).
+         */
+        std::size_t c = 0;
+        if (n >= 3 && n - 3 <= std::numeric_limits<limb_type>::max())
+            c = n - 3;
+
+        detail::mul_columns_from(t, a, b, c);
+        if (c > 0 && t[n - 1] == std::numeric_limits<limb_type>::max())
+            detail::mul_columns_from(t, a, b, 0);
+
+        eval_assign(out, t | std::views::drop(n) | std::views::take(size(a) + size(b) - n));
+    }
+
+
+    /*
+     * out = a * a
+     * Like eval_mul_simple(), but each cross product a[i] * a[j] (i < j) is computed
+     * only once and doubled, so it does about half of the limb multiplications.
+     * @return true if there's overflow
+     */
+    constexpr
+    bool
+    eval_sqr_simple(limb_range auto&& out,
+                    const limb_range auto& a) noexcept
+    {
+        using std::size;
+
+        assert(&a[0] != &out[0]);
+
+        std::ranges::fill(out, 0);
+
+        if (utils::is_zero(a))
+            return false;
+
+        std::size_t top = size(a) - 1;
+        while (!a[top])
+            --top;
+
+        // the top square alone doesn't fit
+        bool overflow = 2 * top >= size(out);
+
+        // cross products, a[i] * a[j] for i < j, only the columns that fit in out
+        const std::size_t rows = std::min(top, size(out));
+        for (std::size_t i = 0; i < rows; ++i) {
+            if (!a[i])
+                continue;
+            const std::size_t j_end = std::min(top + 1, size(out) - i);
+            if (j_end <= i + 1)
+                continue;
+            const limb_type carry = detail::addmul_1(std::ranges::data(out) + 2 * i + 1,
+                                                     std::ranges::data(a) + i + 1,
+                                                     j_end - i - 1,
+                                                     a[i]);
+            if (carry) {
+                // out[i + j_end] was never written by the previous rows
+                if (i + j_end < size(out))
+                    out[i + j_end] = static_cast<limb_type>(carry);
+                else
+                    overflow = true;
+            }
+        }
+
+        // double them
+        limb_type top_bit = 0;
+        for (auto& x : out) {
+            const limb_type next_bit = x >> (limb_bits - 1);
+            x = static_cast<limb_type>(x << 1) | top_bit;
+            top_bit = next_bit;
+        }
+        if (top_bit)
+            overflow = true;
+
+        // add the squares, a[i] * a[i]
+        wide_limb_type carry = 0;
+        for (std::size_t i = 0; 2 * i < size(out); ++i) {
+            const wide_limb_type sq = i <= top ? wide_limb_type{a[i]} * a[i] : 0;
+            carry += static_cast<limb_type>(sq);
+            carry += out[2 * i];
+            out[2 * i] = static_cast<limb_type>(carry);
+            carry >>= limb_bits;
+            carry += sq >> limb_bits;
+            if (2 * i + 1 < size(out)) {
+                carry += out[2 * i + 1];
+                out[2 * i + 1] = static_cast<limb_type>(carry);
+                carry >>= limb_bits;
+            }
+            else
+                break;
+        }
+        if (carry)
+            overflow = true;
+
+        return overflow;
+    }
+
+
+#ifndef XINT_KARATSUBA_THRESHOLD
+#define XINT_KARATSUBA_THRESHOLD 32
+#endif
+
+    // operands with fewer limbs than this are multiplied with the schoolbook method
+    inline constexpr std::size_t karatsuba_threshold = XINT_KARATSUBA_THRESHOLD;
+
+    static_assert(karatsuba_threshold >= 4, "Karatsuba recursion needs at least 4 limbs");
+
+
+#ifndef XINT_KARATSUBA_MUL_THRESHOLD
+#define XINT_KARATSUBA_MUL_THRESHOLD 256
+#endif
+
+    /*
+     * Operands with fewer limbs than this are multiplied by operator * with the
+     * schoolbook method. It's higher than `karatsuba_threshold` because
+     * eval_mul_simple() only computes the limbs that fit in the output, while
+     * eval_mul_karatsuba() always computes the full product.
+     */
+    inline constexpr std::size_t karatsuba_mul_threshold = XINT_KARATSUBA_MUL_THRESHOLD;
+
+
+    // number of scratch limbs needed to multiply two n-limb numbers with Karatsuba
+    constexpr
+    std::size_t
+    karatsuba_scratch_size(std::size_t n)
+        noexcept
+    {
+        if (n < karatsuba_threshold)
+            return 0;
+        const std::size_t m = n - n / 2;
+        // a0+a1, b0+b1, their product, and the scratch for that product
+        return 4 * (m + 1) + karatsuba_scratch_size(m + 1);
+    }
+
+
+    namespace detail {
+
+        /*
+         * out = a * b, where size(a) == size(b) == n, and size(out) == 2n.
+         * This never overflows.
+         */
+        inline
+        void
+        karatsuba_full(std::span<limb_type> out,
+                       std::span<const limb_type> a,
+                       std::span<const limb_type> b,
+                       std::span<limb_type> scratch)
+            noexcept
+        {
+            const std::size_t n = a.size();
+            assert(b.size() == n);
+            assert(out.size() == 2 * n);
+            assert(scratch.size() >= karatsuba_scratch_size(n));
+
+            if (n < karatsuba_threshold) {
+                eval_mul_simple(out, a, b);
+                return;
+            }
+
+            /*
+             * With B = 2^(limb_bits * h):
+             *     a = a1 * B + a0
+             *     b = b1 * B + b0
+             *     a * b = z2 * B^2 + (z1 - z2 - z0) * B + z0
+             * where
+             *     z0 = a0 * b0
+             *     z1 = (a0 + a1) * (b0 + b1)
+             *     z2 = a1 * b1
+             */
+            const std::size_t h = n / 2;
+            const std::size_t m = n - h;
+
+            auto a0 = a.first(h);
+            auto a1 = a.subspan(h);
+            auto b0 = b.first(h);
+            auto b1 = b.subspan(h);
+
+            auto sa   = scratch.subspan(0, m + 1);
+            auto sb   = scratch.subspan(m + 1, m + 1);
+            auto z1   = scratch.subspan(2 * (m + 1), 2 * (m + 1));
+            auto rest = scratch.subspan(4 * (m + 1));
+
+            auto z0 = out.first(2 * h);
+            auto z2 = out.subspan(2 * h);
+
+            karatsuba_full(z0, a0, b0, rest);
+            karatsuba_full(z2, a1, b1, rest);
+
+            eval_add(sa, a0, a1);
+            eval_add(sb, b0, b1);
+            karatsuba_full(z1, sa, sb, rest);
+
+            // these can't underflow, z1 >= z0 + z2
+            eval_sub_inplace(z1, z0);
+            eval_sub_inplace(z1, z2);
+
+            // the top limbs of z1 are zero, so this can't overflow either
+            eval_add_inplace(out.subspan(h), z1);
+        }
+
+
+        /*
+         * out = a * a, where size(a) == n, and size(out) == 2n.
+         * Same as karatsuba_full(), with a == b.
+         */
+        inline
+        void
+        karatsuba_sqr_full(std::span<limb_type> out,
+                           std::span<const limb_type> a,
+                           std::span<limb_type> scratch)
+            noexcept
+        {
+            const std::size_t n = a.size();
+            assert(out.size() == 2 * n);
+            assert(scratch.size() >= karatsuba_scratch_size(n));
+
+            if (n < karatsuba_threshold) {
+                eval_sqr_simple(out, a);
+                return;
+            }
+
+            const std::size_t h = n / 2;
+            const std::size_t m = n - h;
+
+            auto a0 = a.first(h);
+            auto a1 = a.subspan(h);
+
+            auto sa   = scratch.subspan(0, m + 1);
+            auto z1   = scratch.subspan(2 * (m + 1), 2 * (m + 1));
+            auto rest = scratch.subspan(4 * (m + 1));
+
+            auto z0 = out.first(2 * h);
+            auto z2 = out.subspan(2 * h);
+
+            karatsuba_sqr_full(z0, a0, rest);
+            karatsuba_sqr_full(z2, a1, rest);
+
+            eval_add(sa, a0, a1);
+            karatsuba_sqr_full(z1, sa, rest);
+
+            eval_sub_inplace(z1, z0);
+            eval_sub_inplace(z1, z2);
+
+            eval_add_inplace(out.subspan(h), z1);
+        }
+
+    } // namespace detail
+
+
+    /*
+     * out = a * b
+     * `scratch` must have at least 2 * n + karatsuba_scratch_size(n) limbs.
+     * When `a` and `b` have different sizes, the schoolbook method is used instead.
+     * @return true if there's overflow
+     */
+    bool
+    eval_mul_karatsuba(limb_range auto&& out,
+                       const limb_range auto& a,
+                       const limb_range auto& b,
+                       limb_range auto&& scratch)
+        noexcept
+    {
+        using std::size;
+        using std::data;
+
+        if (size(a) != size(b))
+            return eval_mul_simple(out, a, b);
+
+        const std::size_t n = size(a);
+        assert(size(scratch) >= 2 * n + karatsuba_scratch_size(n));
+
+        std::span<limb_type> buf{data(scratch), size(scratch)};
+        auto prod = buf.first(2 * n);
+        detail::karatsuba_full(prod,
+                               std::span<const limb_type>{data(a), n},
+                               std::span<const limb_type>{data(b), n},
+                               buf.subspan(2 * n));
+        return eval_assign(out, prod);
+    }
+
+
+    /*
+     * out = a * a
+     * `scratch` must have at least 2 * n + karatsuba_scratch_size(n) limbs.
+     * @return true if there's overflow
+     */
+    bool
+    eval_sqr_karatsuba(limb_range auto&& out,
+                       const limb_range auto& a,
+                       limb_range auto&& scratch)
+        noexcept
+    {
+        using std::size;
+        using std::data;
+
+        const std::size_t n = size(a);
+        assert(size(scratch) >= 2 * n + karatsuba_scratch_size(n));
+
+        std::span<limb_type> buf{data(scratch), size(scratch)};
+        auto prod = buf.first(2 * n);
+        detail::karatsuba_sqr_full(prod,
+                                   std::span<const limb_type>{data(a), n},
+                                   buf.subspan(2 * n));
+        return eval_assign(out, prod);
+    }
+
+
 }
 
 
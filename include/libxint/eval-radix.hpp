@@ -0,0 +1,587 @@
+#ifndef XINT_EVAL_RADIX_HPP
+#define XINT_EVAL_RADIX_HPP
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef> // std::size_t
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <span>
+#include <utility> // move()
+#include <vector>
+
+#include "types.hpp"
+
+#include "eval-bits.hpp"
+#include "eval-division.hpp"
+#include "eval-multiplication.hpp"
+
+
+/*
+ * Conversion between limbs and digits in bases 2 to 36.
+ */
+
+
+#ifndef XINT_RADIX_DC_THRESHOLD
+#define XINT_RADIX_DC_THRESHOLD 12
+#endif
+
+
+namespace xint {
+
+
+    // numbers with at least this many limbs are converted to digits by divide and conquer
+    inline constexpr std::size_t radix_dc_threshold = XINT_RADIX_DC_THRESHOLD;
+
+    static_assert(radix_dc_threshold >= 2, "divide and conquer needs at least 2 limbs");
+
+
+    namespace detail {
+
+        // ceil(2^32 * log_b(2)), for each base b
+        inline constexpr std::uint64_t log2_ratios[36 + 1] = {
+            0, 0,
+            4294967296, 2709822658, 2147483648, 1849741733, 1661520156, 1529898220,
+            1431655766, 1354911329, 1292913987, 1241523976, 1198050830, 1160664036,
+            1128071164, 1099331346, 1073741824, 1050766078, 1029986702, 1011073585,
+            993761859, 977836273, 963119892, 949465784, 936750802, 924870867,
+            913737343, 903274220, 893415895, 884105414, 875293063, 866935226,
+            858993460, 851433730, 844225783, 837342624, 830760078
+        };
+
+    } // namespace detail
+
+
+    /*
+     * Upper bound for the number of digits of a `bits`-bit number, in base `base`.
+     * It's never more than 2 digits too large.
+     */
+    constexpr
+    std::size_t
+    max_digits(std::size_t bits,
+               unsigned base)
+        noexcept
+    {
+        const std::uint64_t d = std::uint64_t{bits} * detail::log2_ratios[base] >> 32;
+        return static_cast<std::size_t>(d) + 1;
+    }
+
+
+    namespace detail {
+
+        inline constexpr char lower_digits[36 + 1] = "0123456789abcdefghijklmnopqrstuvwxyz";
+        inline constexpr char upper_digits[36 + 1] = "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ";
+
+
+        // the value of each character as a digit; 0xff for anything else
+        inline constexpr std::array<unsigned char, 256> digit_values = []
+        {
+            std::array<unsigned char, 256> t{};
+            t.fill(0xff);
+            for (unsigned i = 0; i < 36; ++i) {
+                t[static_cast<unsigned char>(lower_digits[i])] = static_cast<unsigned char>(i);
+                t[static_cast<unsigned char>(upper_digits[i])] = static_cast<unsigned char>(i);
+            }
+            return t;
+        }();
+
+
+        constexpr
+        unsigned
+        digit_value(char c)
+            noexcept
+        {
+            return digit_values[static_cast<unsigned char>(c)];
+        }
+
+
+        // the largest power of a base that fits in a limb
+        struct radix_chunk {
+            limb_type power;
+            unsigned digits;
+        };
+
+
+        constexpr
+        radix_chunk
+        make_radix_chunk(unsigned base)
+            noexcept
+        {
+            radix_chunk c{static_cast<limb_type>(base), 1};
+            while (c.power <= std::numeric_limits<limb_type>::max() / base) {
+                c.power = static_cast<limb_type>(c.power * base);
+                ++c.digits;
+            }
+            return c;
+        }
+
+
+        constexpr
+        std::size_t
+        significant_limbs(const limb_range auto& a)
+            noexcept
+        {
+            std::size_t n = std::size(a);
+            while (n && !a[n - 1])
+                --n;
+            return n;
+        }
+
+
+        // writes zeros before p, until there are `width` digits before last
+        constexpr
+        char*
+        pad_digits(char* p,
+                   char* last,
+                   std::size_t width)
+            noexcept
+        {
+            while (static_cast<std::size_t>(last - p) < width)
+                *--p = '0';
+            return p;
+        }
+
+
+        // for power of two bases, each digit is just a group of bits
+        constexpr
+        char*
+        to_chars_pow2(char* last,
+                      const limb_range auto& a,
+                      unsigned base,
+                      const char* digits,
+                      std::size_t width)
+            noexcept
+        {
+            using std::size;
+
+            const unsigned shift = std::bit_width(base) - 1;
+            const std::size_t bits = eval_bit_width(a);
+            char* p = last;
+            for (std::size_t i = 0; i < bits; i += shift) {
+                const std::size_t l = i / limb_bits;
+                const unsigned o = i % limb_bits;
+                wide_limb_type v = a[l] >> o;
+                if (o + shift > limb_bits && l + 1 < size(a))
+                    v |= static_cast<wide_limb_type>(a[l + 1]) << (limb_bits - o);
+                *--p = digits[v & (base - 1)];
+            }
+            return pad_digits(p, last, width);
+        }
+
+    } // namespace detail
+
+
+    /*
+     * Writes the digits of `a` backwards, the last one going into last[-1].
+     *
+     * Each division by a single limb produces several digits at once, by dividing by the
+     * largest power of `base` that fits in a limb.
+     * Notes:
+     *     - `a` is destroyed.
+     *     - With a non-zero `width`, zeros are added in front, up to `width` digits.
+     *     - Nothing is written for zero, unless `width` is set.
+     * @return a pointer to the first digit
+     */
+    constexpr
+    char*
+    eval_to_chars_simple(char* last,
+                         limb_range auto&& a,
+                         unsigned base,
+                         bool upper,
+                         std::size_t width = 0)
+        noexcept
+    {
+        const char* digits = upper ? detail::upper_digits : detail::lower_digits;
+        const detail::radix_chunk chunk = detail::make_radix_chunk(base);
+
+        char* p = last;
+        std::size_t len = detail::significant_limbs(a);
+        while (len) {
+            limb_type r = eval_div_inplace_limb(std::span<limb_type>{std::data(a), len},
+                                                chunk.power);
+            // the quotient is at most one limb shorter
+            if (!a[len - 1])
+                --len;
+            if (len) {
+                // not the leading chunk, so all of its digits are written
+                for (unsigned i = 0; i < chunk.digits; ++i) {
+                    *--p = digits[r % base];
+                    r = static_cast<limb_type>(r / base);
+                }
+            } else {
+                while (r) {
+                    *--p = digits[r % base];
+                    r = static_cast<limb_type>(r / base);
+                }
+            }
+        }
+        return detail::pad_digits(p, last, width);
+    }
+
+
+    namespace detail {
+
+        // chunk.power^(2^i), for all i where it has at most max_limbs limbs
+        inline
+        std::vector<std::vector<limb_type>>
+        make_radix_powers(radix_chunk chunk,
+                          std::size_t max_limbs)
+        {
+            std::vector<std::vector<limb_type>> powers;
+            powers.push_back({chunk.power});
+            for (;;) {
+                const auto& prev = powers.back();
+                std::vector<limb_type> next(2 * prev.size());
+                eval_sqr_simple(next, prev);
+                next.resize(significant_limbs(next));
+                if (next.size() > max_limbs)
+                    break;
+                powers.push_back(std::move(next));
+            }
+            return powers;
+        }
+
+
+        /*
+         * Divide and conquer: a = q * P + r, where P = chunk^(2^i) has about half the
+         * limbs of a; r is written with exactly all the digits of P, and q before it.
+         * powers[i] is chunk^(2^i).
+         */
+        inline
+        char*
+        to_chars_dc(char* last,
+                    std::span<limb_type> a,
+                    unsigned base,
+                    bool upper,
+                    std::size_t width,
+                    std::vector<std::vector<limb_type>>& powers,
+                    unsigned chunk_digits)
+        {
+            const std::size_t len = significant_limbs(a);
+            if (len < radix_dc_threshold)
+                return eval_to_chars_simple(last, a.first(len), base, upper, width);
+
+            std::size_t i = powers.size() - 1;
+            while (i > 0 && powers[i].size() > (len + 1) / 2)
+                --i;
+            auto& p = powers[i];
+
+            std::vector<limb_type> q(len - p.size() + 1);
+            std::vector<limb_type> r(p.size() + 1);
+            eval_div(q, r, a.first(len), p);
+
+            const std::size_t low_width = std::size_t{chunk_digits} << i;
+            char* mid = to_chars_dc(last, r, base, upper, low_width, powers, chunk_digits);
+            return to_chars_dc(mid,
+                               q,
+                               base,
+                               upper,
+                               width > low_width ? width - low_width : 0,
+                               powers,
+                               chunk_digits);
+        }
+
+    } // namespace detail
+
+
+    /*
+     * Writes the digits of `a` backwards, the last one going into last[-1]; there must
+     * be room for max_digits() before `last`.
+     *
+     * Large numbers are split recursively by base^(k * 2^i), for the largest base^k that
+     * fits in a limb; the pieces use eval_to_chars_simple() once they're small enough.
+     * The divisions are still quadratic, but they're far fewer than the single-limb
+     * divisions they replace.
+     * Notes:
+     *     - `a` is destroyed.
+     *     - Nothing is written for zero.
+     * @return a pointer to the first digit
+     */
+    char*
+    eval_to_chars(char* last,
+                  limb_range auto&& a,
+                  unsigned base,
+                  bool upper)
+    {
+        if (std::has_single_bit(base))
+            return detail::to_chars_pow2(last,
+                                         a,
+                                         base,
+                                         upper ? detail::upper_digits : detail::lower_digits,
+                                         0);
+
+        const std::size_t len = detail::significant_limbs(a);
+        if (len < radix_dc_threshold)
+            return eval_to_chars_simple(last, a, base, upper);
+
+        const detail::radix_chunk chunk = detail::make_radix_chunk(base);
+        auto powers = detail::make_radix_powers(chunk, (len + 1) / 2);
+        return detail::to_chars_dc(last,
+                                   std::span<limb_type>{std::data(a), len},
+                                   base,
+                                   upper,
+                                   0,
+                                   powers,
+                                   chunk.digits);
+    }
+
+
+
+
+    enum class parse_status {
+        success,
+        invalid_digit,
+        overflow
+    };
+
+
+    // the end of the digits of `base` at the start of [first, last)
+    constexpr
+    const char*
+    scan_digits(const char* first,
+                const char* last,
+                unsigned base)
+        noexcept
+    {
+        while (first != last && detail::digit_value(*first) < base)
+            ++first;
+        return first;
+    }
+
+
+    namespace detail {
+
+        // value of n digits, n must fit in a limb
+        constexpr
+        limb_type
+        chunk_value(const char* p,
+                    unsigned n,
+                    unsigned base)
+            noexcept
+        {
+            limb_type v = 0;
+            for (unsigned i = 0; i < n; ++i)
+                v = static_cast<limb_type>(v * base + digit_value(p[i]));
+            return v;
+        }
+
+
+        /*
+         * a = a * m + c, where only the lower `len` limbs of a can be non-zero; len is
+         * updated. Returns false on overflow.
+         */
+        constexpr
+        bool
+        mul_add_chunk(limb_range auto&& a,
+                      std::size_t& len,
+                      limb_type m,
+                      limb_type c)
+            noexcept
+        {
+            using std::size;
+
+            wide_limb_type carry = c;
+            for (std::size_t i = 0; i < len; ++i) {
+                carry += a[i] * wide_limb_type{m};
+                a[i] = static_cast<limb_type>(carry);
+                carry >>= limb_bits;
+            }
+            if (carry) {
+                if (len == size(a))
+                    return false;
+                a[len++] = static_cast<limb_type>(carry);
+            }
+            return true;
+        }
+
+
+        // each digit is a group of bits, so they're just packed, starting from the end
+        constexpr
+        parse_status
+        from_chars_pow2(limb_range auto&& a,
+                        const char* first,
+                        const char* last,
+                        unsigned base)
+            noexcept
+        {
+            using std::size;
+
+            const unsigned shift = std::bit_width(base) - 1;
+            std::size_t pos = 0;
+            for (const char* p = last; p != first; pos += shift) {
+                const limb_type d = static_cast<limb_type>(digit_value(*--p));
+                if (!d)
+                    continue;
+                const std::size_t l = pos / limb_bits;
+                const unsigned o = pos % limb_bits;
+                if (l >= size(a))
+                    return parse_status::overflow;
+                a[l] |= static_cast<limb_type>(d << o);
+                if (o + shift > limb_bits) {
+                    const limb_type hi = static_cast<limb_type>(d >> (limb_bits - o));
+                    if (hi) {
+                        if (l + 1 >= size(a))
+                            return parse_status::overflow;
+                        a[l + 1] |= hi;
+                    }
+                }
+            }
+            return parse_status::success;
+        }
+
+    } // namespace detail
+
+
+    /*
+     * a = the number in [first, last)
+     *
+     * Horner's method, over chunks of digits: each chunk is added to a * base^k in a
+     * single pass, for the largest base^k that fits in a limb.
+     * Notes:
+     *     - all characters must be digits of `base`; this is not checked.
+     *     - `a` must be zero.
+     */
+    constexpr
+    parse_status
+    eval_from_chars_simple(limb_range auto&& a,
+                           const char* first,
+                           const char* last,
+                           unsigned base)
+        noexcept
+    {
+        using std::empty;
+
+        if (first == last)
+            return parse_status::success;
+        if (empty(a))
+            return parse_status::overflow;
+
+        const detail::radix_chunk chunk = detail::make_radix_chunk(base);
+
+        // the leading chunk takes the leftover digits, so it's never empty
+        const std::size_t count = static_cast<std::size_t>(last - first);
+        const unsigned head = static_cast<unsigned>((count - 1) % chunk.digits + 1);
+        a[0] = detail::chunk_value(first, head, base);
+        first += head;
+
+        std::size_t len = 1; // significant limbs
+        for (; first != last; first += chunk.digits)
+            if (!detail::mul_add_chunk(a,
+                                       len,
+                                       chunk.power,
+                                       detail::chunk_value(first, chunk.digits, base)))
+                return parse_status::overflow;
+        return parse_status::success;
+    }
+
+
+    namespace detail {
+
+        /*
+         * Divide and conquer: the number is hi * P + lo, where P = chunk^(2^i), and lo
+         * has all the digits of P; the multiplication can then use Karatsuba's method.
+         * The pieces use eval_from_chars_simple() once they're too small for that.
+         */
+        inline
+        std::vector<limb_type>
+        from_chars_dc(const char* first,
+                      const char* last,
+                      unsigned base,
+                      const std::vector<std::vector<limb_type>>& powers,
+                      unsigned chunk_digits)
+        {
+            const std::size_t count = static_cast<std::size_t>(last - first);
+            // enough limbs for count digits
+            const std::size_t max_limbs = count * std::bit_width(base) / limb_bits + 1;
+
+            if (max_limbs < 2 * karatsuba_mul_threshold) {
+                std::vector<limb_type> result(max_limbs);
+                eval_from_chars_simple(result, first, last, base);
+                result.resize(significant_limbs(result));
+                return result;
+            }
+
+            // the largest P with fewer digits than the number
+            std::size_t i = powers.size() - 1;
+            while (i > 0 && (std::size_t{chunk_digits} << i) >= count)
+                --i;
+            const std::size_t low_count = std::size_t{chunk_digits} << i;
+            const auto& p = powers[i];
+            const std::size_t n = p.size();
+
+            std::vector<limb_type> hi = from_chars_dc(first, last - low_count, base,
+                                                      powers, chunk_digits);
+            const std::vector<limb_type> lo = from_chars_dc(last - low_count, last, base,
+                                                            powers, chunk_digits);
+
+            std::vector<limb_type> result(std::max(hi.size(), n) + n + 1);
+            // unless there weren't enough powers, hi < P, so it can be padded to n limbs
+            if (hi.size() <= n && n >= karatsuba_mul_threshold) {
+                hi.resize(n);
+                std::vector<limb_type> scratch(2 * n + karatsuba_scratch_size(n));
+                eval_mul_karatsuba(result, hi, p, scratch);
+            } else
+                eval_mul_simple(result, hi, p);
+            eval_add_inplace(result, lo);
+            result.resize(significant_limbs(result));
+            return result;
+        }
+
+    } // namespace detail
+
+
+    /*
+     * a = the number in [first, last), in base `base`.
+     *
+     * Power of two bases just pack the bits of each digit. Long numbers in other bases
+     * are split recursively by powers of the base, to use Karatsuba multiplication;
+     * otherwise it's eval_from_chars_simple().
+     * Notes:
+     *     - All characters must be digits of `base`.
+     *     - Leading zeros never cause an overflow.
+     */
+    parse_status
+    eval_from_chars(limb_range auto&& a,
+                    const char* first,
+                    const char* last,
+                    unsigned base)
+    {
+        using std::size;
+
+        if (scan_digits(first, last, base) != last)
+            return parse_status::invalid_digit;
+
+        std::ranges::fill(a, 0);
+
+        while (first != last && *first == '0')
+            ++first;
+        if (first == last)
+            return parse_status::success;
+
+        // a number with count digits has at least (count - 1) * log2(base) + 1 bits
+        const std::size_t count = static_cast<std::size_t>(last - first);
+        if ((count - 1) * (std::bit_width(base) - 1) >= size(a) * limb_bits)
+            return parse_status::overflow;
+
+        if (std::has_single_bit(base))
+            return detail::from_chars_pow2(a, first, last, base);
+
+        const std::size_t max_limbs = count * std::bit_width(base) / limb_bits + 1;
+        if (max_limbs < 2 * karatsuba_mul_threshold)
+            return eval_from_chars_simple(a, first, last, base);
+
+        const detail::radix_chunk chunk = detail::make_radix_chunk(base);
+        const auto powers = detail::make_radix_powers(chunk, max_limbs / 2 + 1);
+        const auto result = detail::from_chars_dc(first, last, base, powers, chunk.digits);
+        if (eval_assign(a, result))
+            return parse_status::overflow;
+        return parse_status::success;
+    }
+
+
+}
+
+
+#endif
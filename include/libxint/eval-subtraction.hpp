@@ -3,18 +3,45 @@
 
 #include <algorithm>
 #include <array>
+#include <cstddef> // std::size_t
 #include <limits>
 #include <ranges>
 #include <type_traits>
 
+#include "dispatch.hpp"
 #include "types.hpp"
 #include "utils.hpp"
 
 
 namespace xint {
 
+
+    namespace detail {
+
+        /*
+         * out[0, n) = a[0, n) - b[0, n)
+         * `out` may alias `a` or `b`.
+         * @return the borrow (0 or 1)
+         */
+        constexpr
+        limb_type
+        sub_n(limb_type* out,
+              const limb_type* a,
+              const limb_type* b,
+              std::size_t n)
+            noexcept
+        {
+            if (std::is_constant_evaluated())
+                return hw::portable::sub_n(out, a, b, n);
+            return hw::sub_n(out, a, b, n);
+        }
+
+    } // namespace detail
+
+
     // out = a - b
     // returns true if there's underflow
+    constexpr
     bool
     eval_sub(limb_range auto&& out,
              const limb_range auto& a,
@@ -27,10 +54,19 @@ namespace xint {
         using std::size;
 
         signed_wide_limb_type diff = 0;
+        std::size_t i = 0;
+        if (!shift) {
+            // the limbs where all overlap
+            i = std::min({size(out), size(a), size(b)});
+            diff = -signed_wide_limb_type{detail::sub_n(std::ranges::data(out),
+                                                        std::ranges::data(a),
+                                                        std::ranges::data(b),
+                                                        i)};
+        }
         const auto common_size = std::max({size(out),
                                            size(a),
                                            size(b) + shift});
-        for (std::size_t i = 0; i < common_size; ++i) {
+        for (; i < common_size; ++i) {
             if (i < size(a))
                 diff += a[i];
             if (i >= shift && i < size(b) + shift)
@@ -43,8 +79,38 @@ namespace xint {
     }
 
 
+    /*
+     * out = a - b, when all have the same size
+     * Like eval_add_fixed(), there are no tails, and small sizes are unrolled.
+     * `out` may alias `a` or `b`.
+     * @return true if there's underflow
+     */
+    template<std::size_t N>
+    constexpr
+    bool
+    eval_sub_fixed(std::array<limb_type, N>& out,
+                   const std::array<limb_type, N>& a,
+                   const std::array<limb_type, N>& b)
+        noexcept
+    {
+        if constexpr (hw::fast_add_n && N > hw::fixed_limbs)
+            return detail::sub_n(out.data(), a.data(), b.data(), N);
+
+        signed_wide_limb_type diff = 0;
+        utils::for_each_index<N>([&](std::size_t i)
+        {
+            diff += a[i];
+            diff -= b[i];
+            out[i] = static_cast<limb_type>(diff);
+            diff >>= limb_bits;
+        });
+        return diff;
+    }
+
+
     // a -= b
     // returns true if there's underflow
+    constexpr
     bool
     eval_sub_inplace(limb_range auto&& a,
                      const limb_range auto& b)
@@ -57,8 +123,12 @@ namespace xint {
         if (empty(a))
             return is_nonzero(b);
 
-        signed_wide_limb_type diff = 0;
-        for (std::size_t i = 0; i < size(a); ++i) {
+        std::size_t i = std::min(size(a), size(b));
+        signed_wide_limb_type diff = -signed_wide_limb_type{detail::sub_n(std::ranges::data(a),
+                                                                          std::ranges::data(a),
+                                                                          std::ranges::data(b),
+                                                                          i)};
+        for (; i < size(a); ++i) {
             diff += a[i];
             if (i < size(b))
                 diff -= b[i];
@@ -78,6 +148,7 @@ namespace xint {
 
     // a -= b (single limb)
     // returns true if there's underflow
+    constexpr
     bool
     eval_sub_inplace_limb(limb_range auto&& a,
                           limb_type b)
@@ -0,0 +1,485 @@
+#ifndef XINT_EXPRESSION_HPP
+#define XINT_EXPRESSION_HPP
+
+#include <concepts>
+#include <functional>
+#include <stdexcept>
+#include <type_traits>
+#include <utility> // move()
+
+#include "eval-addition.hpp"
+#include "eval-bits.hpp"
+#include "eval-multiplication.hpp"
+#include "eval-subtraction.hpp"
+#include "operators.hpp"
+#include "traits.hpp"
+#include "uint.hpp"
+
+
+/*
+ * Lazy evaluation of arithmetic expressions.
+ *
+ * Wrapping an operand with xint::lazy() makes the operators build an expression tree
+ * instead of computing each intermediate result. The tree is evaluated when it's
+ * converted to a uint, or through eval():
+ *
+ *     U r = lazy(a) * b + c;                // one pass, no temporary for a * b
+ *     r = (lazy(r) * x) % m;                // product computed at full width
+ *     U f = (lazy(a) >> 12) & mask;         // one pass
+ *
+ * These patterns are fused:
+ *     - `a * b + c` and `c + a * b`, through eval_mul_add().
+ *     - `(a * b) % m`: the product is computed with all its bits, so unlike the regular
+ *       operators it never overflows.
+ *     - `(a << s) & m` and `(a >> s) & m`, for unsafe types (the safe shifts check
+ *       for lost bits, so they're evaluated as usual).
+ * Chains of +, -, &, |, ^ are evaluated into the result, without temporaries.
+ *
+ * The tree holds references to its uint operands, so it must be evaluated before the
+ * end of the full-expression that created it; don't store it in an `auto` variable.
+ */
+
+
+namespace xint {
+
+
+    namespace expr {
+
+
+        template<typename T>
+        struct is_expression : std::false_type {};
+
+        template<typename T>
+        inline constexpr bool is_expression_v = is_expression<std::remove_cvref_t<T>>::value;
+
+        template<typename T>
+        concept expression = is_expression_v<T>;
+
+        template<typename T>
+        concept operand = expression<T> || unsigned_integral<T> || std::integral<T>;
+
+
+
+        // base class for all nodes: evaluation and conversion
+        template<typename Derived,
+                 unsigned_integral V>
+        struct node {
+
+            using value_type = V;
+
+
+            value_type
+            eval()
+                const
+            {
+                value_type result;
+                static_cast<const Derived&>(*this).eval_into(result);
+                return result;
+            }
+
+
+            template<unsigned_integral U>
+            operator U()
+                const
+            {
+                if constexpr (std::same_as<U, value_type>)
+                    return eval();
+                else
+                    return U{eval()};
+            }
+
+        };
+
+
+
+        // a uint operand; T is either `const U&` or `U`
+        template<typename T>
+        struct leaf : node<leaf<T>, std::remove_cvref_t<T>> {
+
+            using value_type = std::remove_cvref_t<T>;
+
+            T val;
+
+
+            explicit
+            leaf(T v) :
+                val(std::forward<T>(v))
+            {}
+
+
+            void
+            eval_into(value_type& out)
+                const
+            {
+                out = val;
+            }
+
+        };
+
+        template<typename T>
+        struct is_expression<leaf<T>> : std::true_type {};
+
+
+
+        // value of an operand: a reference for leaves, a temporary otherwise
+        template<expression E>
+        decltype(auto)
+        value(const E& e)
+        {
+            if constexpr (requires { e.val; })
+                return (e.val);
+            else
+                return e.eval();
+        }
+
+
+
+        template<typename Op,
+                 typename L,
+                 typename R>
+        struct binary;
+
+        template<typename Op,
+                 typename L,
+                 typename R>
+        struct is_expression<binary<Op, L, R>> : std::true_type {};
+
+
+        template<typename E, typename Op>
+        inline constexpr bool is_binary_v = false;
+
+        template<typename Op, typename L, typename R>
+        inline constexpr bool is_binary_v<binary<Op, L, R>, Op> = true;
+
+
+
+        template<bool Left,
+                 typename E>
+        struct shift;
+
+        template<bool Left,
+                 typename E>
+        struct is_expression<shift<Left, E>> : std::true_type {};
+
+        template<typename E>
+        inline constexpr bool is_shift_v = false;
+
+        template<bool Left, typename E>
+        inline constexpr bool is_shift_v<shift<Left, E>> = true;
+
+
+
+        template<typename Op,
+                 typename L,
+                 typename R>
+        using binary_value_t =
+            std::conditional_t<std::same_as<Op, std::divides<>>
+                               || std::same_as<Op, std::modulus<>>,
+                               typename L::value_type,
+                               std::common_type_t<typename L::value_type,
+                                                  typename R::value_type>>;
+
+
+        template<typename Op,
+                 typename L,
+                 typename R>
+        struct binary : node<binary<Op, L, R>, binary_value_t<Op, L, R>> {
+
+            using value_type = binary_value_t<Op, L, R>;
+
+            L lhs;
+            R rhs;
+
+
+            binary(const L& l,
+                   const R& r) :
+                lhs(l),
+                rhs(r)
+            {}
+
+
+            void
+            eval_into(value_type& out)
+                const
+            {
+                constexpr bool add = std::same_as<Op, std::plus<>>;
+                constexpr bool sub = std::same_as<Op, std::minus<>>;
+                constexpr bool mul = std::same_as<Op, std::multiplies<>>;
+                constexpr bool mod = std::same_as<Op, std::modulus<>>;
+                constexpr bool band = std::same_as<Op, std::bit_and<>>;
+                constexpr bool bor = std::same_as<Op, std::bit_or<>>;
+                constexpr bool bxor = std::same_as<Op, std::bit_xor<>>;
+                constexpr bool safe = is_safe_v<value_type>;
+
+                if constexpr (add && is_binary_v<L, std::multiplies<>>
+                              && std::same_as<typename L::value_type, value_type>)
+                    mul_add(out, lhs.lhs, lhs.rhs, rhs);
+                else if constexpr (add && is_binary_v<R, std::multiplies<>>
+                                   && std::same_as<typename R::value_type, value_type>)
+                    mul_add(out, rhs.lhs, rhs.rhs, lhs);
+                else if constexpr (mod && is_binary_v<L, std::multiplies<>>)
+                    mul_mod(out, lhs.lhs, lhs.rhs, rhs);
+                else if constexpr (band && is_shift_v<L> && !safe)
+                    shift_and(out, lhs, rhs);
+                else if constexpr (band && is_shift_v<R> && !safe)
+                    shift_and(out, rhs, lhs);
+                else if constexpr (mul) {
+                    bool overflow = detail::mul(out.limbs(), value(lhs), value(rhs));
+                    if constexpr (safe)
+                        if (overflow)
+                            throw std::overflow_error{"overflow in *"};
+                } else if constexpr ((add || sub || band || bor || bxor)
+                                     && std::same_as<typename L::value_type, value_type>) {
+                    // a leaf on the left is read directly, anything else is evaluated
+                    // into out first
+                    decltype(auto) r = value(rhs);
+                    if constexpr (requires { lhs.val; })
+                        apply(out, lhs.val.limbs(), r.limbs());
+                    else {
+                        lhs.eval_into(out);
+                        apply(out, out.limbs(), r.limbs());
+                    }
+                } else
+                    out = Op{}(value(lhs), value(rhs));
+            }
+
+        private:
+
+            // out = a op b, for the limb-wise operators; out may alias a
+            static
+            void
+            apply(value_type& out,
+                  const limb_range auto& a,
+                  const limb_range auto& b)
+            {
+                constexpr bool safe = is_safe_v<value_type>;
+                if constexpr (std::same_as<Op, std::plus<>>) {
+                    bool overflow = eval_add(out.limbs(), a, b);
+                    if constexpr (safe)
+                        if (overflow)
+                            throw std::overflow_error{"overflow in +"};
+                } else if constexpr (std::same_as<Op, std::minus<>>) {
+                    bool overflow = eval_sub(out.limbs(), a, b);
+                    if constexpr (safe)
+                        if (overflow)
+                            throw std::overflow_error{"overflow in -"};
+                } else if constexpr (std::same_as<Op, std::bit_and<>>)
+                    eval_bit_and(out.limbs(), a, b);
+                else if constexpr (std::same_as<Op, std::bit_or<>>)
+                    eval_bit_or(out.limbs(), a, b);
+                else
+                    eval_bit_xor(out.limbs(), a, b);
+            }
+
+
+            template<typename A,
+                     typename B,
+                     typename C>
+            static
+            void
+            mul_add(value_type& out,
+                    const A& a,
+                    const B& b,
+                    const C& c)
+            {
+                bool overflow = eval_mul_add(out.limbs(),
+                                             value(a).limbs(),
+                                             value(b).limbs(),
+                                             value(c).limbs());
+                if constexpr (is_safe_v<value_type>)
+                    if (overflow)
+                        throw std::overflow_error{"overflow in a * b + c"};
+            }
+
+
+            template<typename A,
+                     typename B,
+                     typename M>
+            static
+            void
+            mul_mod(value_type& out,
+                    const A& a,
+                    const B& b,
+                    const M& m)
+            {
+                decltype(auto) va = value(a);
+                decltype(auto) vb = value(b);
+                using UA = std::remove_cvref_t<decltype(va)>;
+                using UB = std::remove_cvref_t<decltype(vb)>;
+                // the full product, it can't overflow
+                uint<UA::num_bits + UB::num_bits> p;
+                detail::mul(p.limbs(), va, vb);
+                out = div(std::move(p), value(m)).second;
+            }
+
+
+            template<typename S,
+                     typename M>
+            static
+            void
+            shift_and(value_type& out,
+                      const S& s,
+                      const M& m)
+            {
+                if constexpr (S::left)
+                    eval_bit_shift_left_and(out.limbs(),
+                                            value(s.arg).limbs(),
+                                            s.amount,
+                                            value(m).limbs());
+                else
+                    eval_bit_shift_right_and(out.limbs(),
+                                             value(s.arg).limbs(),
+                                             s.amount,
+                                             value(m).limbs());
+            }
+
+        };
+
+
+
+        template<bool Left,
+                 typename E>
+        struct shift : node<shift<Left, E>, typename E::value_type> {
+
+            using value_type = E::value_type;
+
+            static constexpr inline bool left = Left;
+
+            E arg;
+            unsigned amount;
+
+
+            shift(const E& e,
+                  unsigned s) :
+                arg(e),
+                amount(s)
+            {}
+
+
+            void
+            eval_into(value_type& out)
+                const
+            {
+                constexpr bool safe = is_safe_v<value_type>;
+                bool overflow;
+                if constexpr (Left)
+                    overflow = eval_bit_shift_left<safe>(out.limbs(),
+                                                         value(arg).limbs(),
+                                                         amount);
+                else
+                    overflow = eval_bit_shift_right<safe>(out.limbs(),
+                                                          value(arg).limbs(),
+                                                          amount);
+                if constexpr (safe)
+                    if (overflow)
+                        throw std::overflow_error{Left ? "overflow in <<" : "overflow in >>"};
+            }
+
+        };
+
+
+
+        // turn any operand into an expression node
+        template<operand T>
+        auto
+        as_expression(const T& x)
+        {
+            if constexpr (expression<T>)
+                return x;
+            else if constexpr (unsigned_integral<T>)
+                return leaf<const T&>{x};
+            else
+                return leaf<decltype(uint(x))>{uint(x)};
+        }
+
+
+        template<typename Op,
+                 operand L,
+                 operand R>
+        auto
+        make_binary(const L& l,
+                    const R& r)
+        {
+            using LE = decltype(as_expression(l));
+            using RE = decltype(as_expression(r));
+            return binary<Op, LE, RE>{as_expression(l), as_expression(r)};
+        }
+
+
+#define XINT_EXPR_BINARY_OPERATOR(op, func)                     \
+        template<operand L,                                     \
+                 operand R>                                     \
+        requires (expression<L> || expression<R>)               \
+        auto                                                    \
+        operator op(const L& l,                                 \
+                    const R& r)                                 \
+        {                                                       \
+            return make_binary<func>(l, r);                     \
+        }
+
+        XINT_EXPR_BINARY_OPERATOR(+, std::plus<>)
+        XINT_EXPR_BINARY_OPERATOR(-, std::minus<>)
+        XINT_EXPR_BINARY_OPERATOR(*, std::multiplies<>)
+        XINT_EXPR_BINARY_OPERATOR(/, std::divides<>)
+        XINT_EXPR_BINARY_OPERATOR(%, std::modulus<>)
+        XINT_EXPR_BINARY_OPERATOR(&, std::bit_and<>)
+        XINT_EXPR_BINARY_OPERATOR(|, std::bit_or<>)
+        XINT_EXPR_BINARY_OPERATOR(^, std::bit_xor<>)
+
+#undef XINT_EXPR_BINARY_OPERATOR
+
+
+        template<expression E>
+        shift<true, E>
+        operator <<(const E& e,
+                    unsigned s)
+        {
+            return {e, s};
+        }
+
+
+        template<expression E>
+        shift<false, E>
+        operator >>(const E& e,
+                    unsigned s)
+        {
+            return {e, s};
+        }
+
+
+    } // namespace expr
+
+
+
+    // start a lazy expression
+    template<unsigned_integral U>
+    expr::leaf<const U&>
+    lazy(const U& x)
+        noexcept
+    {
+        return expr::leaf<const U&>{x};
+    }
+
+
+    // a temporary is moved into the expression
+    template<unsigned_integral U>
+    requires (!std::is_lvalue_reference_v<U>)
+    expr::leaf<U>
+    lazy(U&& x)
+    {
+        return expr::leaf<U>{std::move(x)};
+    }
+
+
+    template<expr::expression E>
+    typename E::value_type
+    eval(const E& e)
+    {
+        return e.eval();
+    }
+
+
+}
+
+
+#endif
@@ -0,0 +1,354 @@
+#ifndef XINT_FORMAT_HPP
+#define XINT_FORMAT_HPP
+
+#include <version>
+
+#if __cpp_lib_format >= 201907L
+
+#include <algorithm> // copy(), fill_n()
+#include <array>
+#include <climits> // CHAR_MAX
+#include <cstddef> // std::size_t
+#include <format>
+#include <locale>
+#include <string>
+#include <type_traits>
+#include <utility> // cmp_less()
+
+#include "charconv.hpp"
+#include "eval-radix.hpp"
+#include "traits.hpp"
+#include "uint.hpp"
+
+
+/*
+ * std::format() support. The format specification is
+ *
+ *     [[fill]align][sign][#][0][width][L][type]
+ *
+ * with the same meaning as for the built-in integers, and type is one of b, B, o, d, x
+ * or X (default is d). The L option groups the digits as the locale's numpunct says.
+ *
+ * The digits are produced by to_chars(), so for types with local storage nothing is
+ * allocated, other than the grouping string when L is used.
+ * The fill must be a single char.
+ */
+
+
+namespace xint::detail {
+
+
+    struct format_spec {
+
+        char fill = ' ';
+        char align = 0; // one of '<', '^', '>', or 0 for the default
+        char sign = '-';
+        bool alt = false;
+        bool zero = false;
+        bool localized = false;
+        char type = 'd';
+        std::size_t width = 0;
+        int width_arg = -1; // the argument holding the width, when >= 0
+
+
+        static
+        constexpr
+        bool
+        is_align(char c)
+            noexcept
+        {
+            return c == '<' || c == '^' || c == '>';
+        }
+
+
+        // `Iterator` is ParseContext::iterator, which doesn't have to be a pointer
+        template<typename Iterator>
+        static
+        constexpr
+        std::size_t
+        parse_number(Iterator& it,
+                     const Iterator end)
+        {
+            std::size_t n = 0;
+            if (it == end || *it < '0' || *it > '9')
+                throw std::format_error{"expected a number in format specification"};
+            while (it != end && *it >= '0' && *it <= '9') {
+                n = n * 10 + static_cast<std::size_t>(*it++ - '0');
+                if (n > 0xffffff)
+                    throw std::format_error{"number is too large in format specification"};
+            }
+            return n;
+        }
+
+
+        template<typename ParseContext>
+        constexpr
+        typename ParseContext::iterator
+        parse(ParseContext& ctx)
+        {
+            typename ParseContext::iterator it = ctx.begin();
+            const typename ParseContext::iterator end = ctx.end();
+            auto done = [&it, end]() -> bool
+            {
+                return it == end || *it == '}';
+            };
+
+            if (end - it >= 2 && is_align(it[1])) {
+                if (*it == '{' || *it == '}')
+                    throw std::format_error{"invalid fill character"};
+                fill = it[0];
+                align = it[1];
+                it += 2;
+            } else if (it != end && is_align(*it))
+                align = *it++;
+
+            if (!done() && (*it == '+' || *it == '-' || *it == ' '))
+                sign = *it++;
+
+            if (!done() && *it == '#') {
+                alt = true;
+                ++it;
+            }
+
+            if (!done() && *it == '0') {
+                zero = true;
+                ++it;
+            }
+
+            if (!done()) {
+                if (*it >= '1' && *it <= '9')
+                    width = parse_number(it, end);
+                else if (*it == '{') {
+                    ++it;
+                    if (it != end && *it == '}')
+                        width_arg = static_cast<int>(ctx.next_arg_id());
+                    else {
+                        const std::size_t id = parse_number(it, end);
+                        ctx.check_arg_id(id);
+                        width_arg = static_cast<int>(id);
+                    }
+                    if (it == end || *it != '}')
+                        throw std::format_error{"invalid width in format specification"};
+                    ++it;
+                }
+            }
+
+            if (!done() && *it == 'L') {
+                localized = true;
+                ++it;
+            }
+
+            if (!done())
+                switch (*it) {
+                    case 'b':
+                    case 'B':
+                    case 'o':
+                    case 'd':
+                    case 'x':
+                    case 'X':
+                        type = *it++;
+                        break;
+                    default:
+                        throw std::format_error{"invalid type in format specification"};
+                }
+
+            if (!done())
+                throw std::format_error{"invalid format specification"};
+
+            return it;
+        }
+
+
+        constexpr
+        unsigned
+        base()
+            const noexcept
+        {
+            switch (type) {
+                case 'b':
+                case 'B':
+                    return 2;
+                case 'o':
+                    return 8;
+                case 'x':
+                case 'X':
+                    return 16;
+                default:
+                    return 10;
+            }
+        }
+
+
+        template<typename FormatContext>
+        std::size_t
+        get_width(FormatContext& ctx)
+            const
+        {
+            if (width_arg < 0)
+                return width;
+            auto visitor = []<typename T>(T arg) -> std::size_t
+            {
+                if constexpr (std::is_integral_v<T>
+                              && !std::is_same_v<T, bool>
+                              && !std::is_same_v<T, char>) {
+                    if (std::cmp_less(arg, 0))
+                        throw std::format_error{"width is negative"};
+                    return static_cast<std::size_t>(arg);
+                } else
+                    throw std::format_error{"width is not an integer"};
+            };
+            return std::visit_format_arg(visitor, ctx.arg(static_cast<std::size_t>(width_arg)));
+        }
+
+    };
+
+
+    // size of the group of digits before the k-th separator, counting from the right
+    inline
+    int
+    group_size(const std::string& grouping,
+               std::size_t k)
+        noexcept
+    {
+        const char g = grouping[k < grouping.size() ? k : grouping.size() - 1];
+        return g <= 0 || g == CHAR_MAX ? 0 : g;
+    }
+
+
+    template<unsigned_integral U,
+             typename FormatContext>
+    typename FormatContext::iterator
+    format_uint(const U& value,
+                const format_spec& spec,
+                FormatContext& ctx)
+    {
+        const unsigned base = spec.base();
+
+        // base 2 needs the most digits: one per bit
+        std::array<char, U::is_local ? U::num_bits : 1> local_buf;
+        std::string heap_buf;
+        char* const first = [&]
+        {
+            if constexpr (U::is_local)
+                return local_buf.data();
+            else {
+                heap_buf.resize(max_digits(U::num_bits, base));
+                return heap_buf.data();
+            }
+        }();
+        char* const last = to_chars(first,
+                                    first + (U::is_local ? local_buf.size() : heap_buf.size()),
+                                    value,
+                                    static_cast<int>(base)).ptr;
+        const std::size_t num_digits = static_cast<std::size_t>(last - first);
+
+        char prefix[3];
+        std::size_t prefix_len = 0;
+        if (spec.sign == '+' || spec.sign == ' ')
+            prefix[prefix_len++] = spec.sign;
+        if (spec.alt && base != 10) {
+            // the octal prefix is the leading zero, so zero itself has none
+            if (base != 8 || *first != '0')
+                prefix[prefix_len++] = '0';
+            if (base != 8)
+                prefix[prefix_len++] = spec.type;
+        }
+
+        std::string grouping;
+        char separator = 0;
+        std::size_t head = num_digits; // digits before the first separator
+        std::size_t num_seps = 0;
+        if (spec.localized) {
+            const auto& facet = std::use_facet<std::numpunct<char>>(ctx.locale());
+            grouping = facet.grouping();
+            separator = facet.thousands_sep();
+            if (!grouping.empty())
+                for (int size = group_size(grouping, 0);
+                     size > 0 && head > static_cast<std::size_t>(size);
+                     size = group_size(grouping, num_seps)) {
+                    head -= static_cast<std::size_t>(size);
+                    ++num_seps;
+                }
+        }
+
+        const std::size_t len = prefix_len + num_digits + num_seps;
+        const std::size_t width = spec.get_width(ctx);
+        const std::size_t padding = width > len ? width - len : 0;
+        std::size_t left_padding = 0;
+        std::size_t zero_padding = 0;
+        if (spec.zero && !spec.align)
+            zero_padding = padding;
+        else if (spec.align == '<')
+            left_padding = 0;
+        else if (spec.align == '^')
+            left_padding = padding / 2;
+        else
+            left_padding = padding;
+        const std::size_t right_padding = padding - left_padding - zero_padding;
+
+        const bool upper = spec.type == 'X';
+        auto write_digits = [upper](auto out,
+                                    const char* src,
+                                    std::size_t n)
+        {
+            for (; n; --n, ++src)
+                *out++ = upper && *src >= 'a' ? static_cast<char>(*src - 'a' + 'A') : *src;
+            return out;
+        };
+
+        auto out = ctx.out();
+        out = std::fill_n(out, left_padding, spec.fill);
+        out = std::copy(prefix, prefix + prefix_len, out);
+        out = std::fill_n(out, zero_padding, '0');
+        const char* src = first;
+        out = write_digits(out, src, head);
+        src += head;
+        for (std::size_t k = num_seps; k-- > 0;) {
+            const auto size = static_cast<std::size_t>(group_size(grouping, k));
+            *out++ = separator;
+            out = write_digits(out, src, size);
+            src += size;
+        }
+        out = std::fill_n(out, right_padding, spec.fill);
+        return out;
+    }
+
+
+} // namespace xint::detail
+
+
+namespace std {
+
+    template<unsigned Bits, bool Safe>
+    struct formatter<xint::uint<Bits, Safe>, char> {
+
+        xint::detail::format_spec spec;
+
+
+        template<typename ParseContext>
+        constexpr
+        typename ParseContext::iterator
+        parse(ParseContext& ctx)
+        {
+            return spec.parse(ctx);
+        }
+
+
+        template<typename FormatContext>
+        typename FormatContext::iterator
+        format(const xint::uint<Bits, Safe>& value,
+               FormatContext& ctx)
+            const
+        {
+            return xint::detail::format_uint(value, spec, ctx);
+        }
+
+    };
+
+} // namespace std
+
+
+#endif // __cpp_lib_format
+
+
+#endif
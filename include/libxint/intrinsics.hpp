@@ -0,0 +1,378 @@
+#ifndef XINT_INTRINSICS_HPP
+#define XINT_INTRINSICS_HPP
+
+#include <cstddef> // std::size_t
+
+#include "types.hpp"
+
+
+/*
+ * Hardware carry chains, for 64-bit limbs.
+ *
+ * The portable kernels keep the carry in a wide_limb_type and shift it down, which
+ * compilers rarely turn into a chain of adc instructions. The functions here work on
+ * raw limb pointers; dispatch.hpp picks which ones the kernels use.
+ *
+ *   - hw::x86_64: adc/sbb loops, for any x86-64 CPU.
+ *   - hw::adx: multiplication rows with mulx and two independent carry chains: adox
+ *     (OF) adds the high half of the previous product, adcx (CF) accumulates into the
+ *     output. These need a CPU with BMI2 and ADX (Broadwell, Zen and later.) The
+ *     assembler accepts them without -madx -mbmi2, so they're always compiled on
+ *     x86-64; XINT_HW_ADX tells if the target is known to have them.
+ *   - hw::addc: __builtin_addcll() and __builtin_subcll(), on other targets.
+ *
+ * The loops are inline asm because the compilers don't keep the carry flag live
+ * across _addcarry_u64() calls, and they never interleave adcx and adox.
+ *
+ * Define XINT_USE_INTRINSICS=0 to always use the portable code.
+ */
+
+
+#ifndef XINT_USE_INTRINSICS
+#define XINT_USE_INTRINSICS 1
+#endif
+
+
+#if XINT_USE_INTRINSICS && XINT_LIMB_SIZE == 64
+#if defined(__x86_64__) && defined(__GNUC__)
+#define XINT_HW_X86_64 1
+#if defined(__ADX__) && defined(__BMI2__)
+#define XINT_HW_ADX 1
+#endif
+#elif defined(__has_builtin)
+#if __has_builtin(__builtin_addcll) && __has_builtin(__builtin_subcll)
+#define XINT_HW_ADDC 1
+#endif
+#endif
+#endif
+
+
+
+namespace xint::hw {
+
+
+#ifdef XINT_HW_X86_64
+
+
+    namespace x86_64 {
+
+        /*
+         * out[0, n) = a[0, n) + b[0, n)
+         * `out` may alias `a` or `b`.
+         * @return the carry (0 or 1)
+         */
+        inline
+        limb_type
+        add_n(limb_type* out,
+              const limb_type* a,
+              const limb_type* b,
+              std::size_t n)
+            noexcept
+        {
+            std::size_t blocks = n / 4;
+            std::size_t rest = n % 4;
+            limb_type t0;
+            limb_type t1;
+            // note: test clears CF; dec and lea leave it alone
+            asm volatile("test %[blocks], %[blocks]\n\t"
+                         "jz 2f\n"
+                         "1:\n\t"
+                         "mov (%[a]), %[t0]\n\t"
+                         "mov 8(%[a]), %[t1]\n\t"
+                         "adc (%[b]), %[t0]\n\t"
+                         "adc 8(%[b]), %[t1]\n\t"
+                         "mov %[t0], (%[out])\n\t"
+                         "mov %[t1], 8(%[out])\n\t"
+                         "mov 16(%[a]), %[t0]\n\t"
+                         "mov 24(%[a]), %[t1]\n\t"
+                         "adc 16(%[b]), %[t0]\n\t"
+                         "adc 24(%[b]), %[t1]\n\t"
+                         "mov %[t0], 16(%[out])\n\t"
+                         "mov %[t1], 24(%[out])\n\t"
+                         "lea 32(%[a]), %[a]\n\t"
+                         "lea 32(%[b]), %[b]\n\t"
+                         "lea 32(%[out]), %[out]\n\t"
+                         "dec %[blocks]\n\t"
+                         "jnz 1b\n"
+                         "2:\n\t"
+                         "dec %[rest]\n\t"
+                         "js 3f\n\t"
+                         "mov (%[a]), %[t0]\n\t"
+                         "adc (%[b]), %[t0]\n\t"
+                         "mov %[t0], (%[out])\n\t"
+                         "lea 8(%[a]), %[a]\n\t"
+                         "lea 8(%[b]), %[b]\n\t"
+                         "lea 8(%[out]), %[out]\n\t"
+                         "jmp 2b\n"
+                         "3:\n\t"
+                         "mov $0, %k[t0]\n\t"
+                         "adc $0, %k[t0]"
+                         : [out] "+r" (out),
+                           [a] "+r" (a),
+                           [b] "+r" (b),
+                           [blocks] "+r" (blocks),
+                           [rest] "+r" (rest),
+                           [t0] "=&r" (t0),
+                           [t1] "=&r" (t1)
+                         :
+                         : "cc", "memory");
+            return t0;
+        }
+
+
+        /*
+         * out[0, n) = a[0, n) - b[0, n)
+         * `out` may alias `a` or `b`.
+         * @return the borrow (0 or 1)
+         */
+        inline
+        limb_type
+        sub_n(limb_type* out,
+              const limb_type* a,
+              const limb_type* b,
+              std::size_t n)
+            noexcept
+        {
+            std::size_t blocks = n / 4;
+            std::size_t rest = n % 4;
+            limb_type t0;
+            limb_type t1;
+            asm volatile("test %[blocks], %[blocks]\n\t"
+                         "jz 2f\n"
+                         "1:\n\t"
+                         "mov (%[a]), %[t0]\n\t"
+                         "mov 8(%[a]), %[t1]\n\t"
+                         "sbb (%[b]), %[t0]\n\t"
+                         "sbb 8(%[b]), %[t1]\n\t"
+                         "mov %[t0], (%[out])\n\t"
+                         "mov %[t1], 8(%[out])\n\t"
+                         "mov 16(%[a]), %[t0]\n\t"
+                         "mov 24(%[a]), %[t1]\n\t"
+                         "sbb 16(%[b]), %[t0]\n\t"
+                         "sbb 24(%[b]), %[t1]\n\t"
+                         "mov %[t0], 16(%[out])\n\t"
+                         "mov %[t1], 24(%[out])\n\t"
+                         "lea 32(%[a]), %[a]\n\t"
+                         "lea 32(%[b]), %[b]\n\t"
+                         "lea 32(%[out]), %[out]\n\t"
+                         "dec %[blocks]\n\t"
+                         "jnz 1b\n"
+                         "2:\n\t"
+                         "dec %[rest]\n\t"
+                         "js 3f\n\t"
+                         "mov (%[a]), %[t0]\n\t"
+                         "sbb (%[b]), %[t0]\n\t"
+                         "mov %[t0], (%[out])\n\t"
+                         "lea 8(%[a]), %[a]\n\t"
+                         "lea 8(%[b]), %[b]\n\t"
+                         "lea 8(%[out]), %[out]\n\t"
+                         "jmp 2b\n"
+                         "3:\n\t"
+                         "mov $0, %k[t0]\n\t"
+                         "adc $0, %k[t0]"
+                         : [out] "+r" (out),
+                           [a] "+r" (a),
+                           [b] "+r" (b),
+                           [blocks] "+r" (blocks),
+                           [rest] "+r" (rest),
+                           [t0] "=&r" (t0),
+                           [t1] "=&r" (t1)
+                         :
+                         : "cc", "memory");
+            return t0;
+        }
+
+    } // namespace x86_64
+
+
+#elif defined(XINT_HW_ADDC)
+
+
+    namespace addc {
+
+        // out[0, n) = a[0, n) + b[0, n); returns the carry
+        inline
+        limb_type
+        add_n(limb_type* out,
+              const limb_type* a,
+              const limb_type* b,
+              std::size_t n)
+            noexcept
+        {
+            unsigned long long carry = 0;
+            for (std::size_t i = 0; i < n; ++i)
+                out[i] = __builtin_addcll(a[i], b[i], carry, &carry);
+            return carry;
+        }
+
+
+        // out[0, n) = a[0, n) - b[0, n); returns the borrow
+        inline
+        limb_type
+        sub_n(limb_type* out,
+              const limb_type* a,
+              const limb_type* b,
+              std::size_t n)
+            noexcept
+        {
+            unsigned long long borrow = 0;
+            for (std::size_t i = 0; i < n; ++i)
+                out[i] = __builtin_subcll(a[i], b[i], borrow, &borrow);
+            return borrow;
+        }
+
+    } // namespace addc
+
+
+#endif
+
+
+#ifdef XINT_HW_X86_64
+
+
+// one column of mul_1(): lo:hi = a[k] * b, out[k] = lo + previous hi + CF
+#define XINT_HW_MUL_STEP(k)                     \
+    "mulx " #k "(%[a]), %[lo], %[hi]\n\t"      \
+    "adcx %[prev], %[lo]\n\t"                   \
+    "mov %[lo], " #k "(%[out])\n\t"             \
+    "mov %[hi], %[prev]\n\t"
+
+// one column of addmul_1(): lo:hi = a[k] * b, out[k] += lo + previous hi, on two chains
+#define XINT_HW_ADDMUL_STEP(k)                  \
+    "mulx " #k "(%[a]), %[lo], %[hi]\n\t"      \
+    "adox %[prev], %[lo]\n\t"                   \
+    "adcx " #k "(%[out]), %[lo]\n\t"            \
+    "mov %[lo], " #k "(%[out])\n\t"             \
+    "mov %[hi], %[prev]\n\t"
+
+
+    namespace adx {
+
+        /*
+         * out[0, n) = a[0, n) * b
+         * `out` may alias `a`.
+         * @return the high limb of the product
+         */
+        inline
+        limb_type
+        mul_1(limb_type* out,
+              const limb_type* a,
+              std::size_t n,
+              limb_type b)
+            noexcept
+        {
+            std::size_t count = n % 4;
+            const std::size_t blocks = n / 4;
+            limb_type lo;
+            limb_type hi;
+            limb_type prev = 0;
+            // note: the loops are controlled by lea and jrcxz, which leave the flags alone
+            asm volatile("xor %k[lo], %k[lo]\n\t"
+                         "jrcxz 2f\n"
+                         "1:\n\t"
+                         XINT_HW_MUL_STEP(0)
+                         "lea 8(%[a]), %[a]\n\t"
+                         "lea 8(%[out]), %[out]\n\t"
+                         "lea -1(%[count]), %[count]\n\t"
+                         "jrcxz 2f\n\t"
+                         "jmp 1b\n"
+                         "2:\n\t"
+                         "mov %[blocks], %[count]\n\t"
+                         "jrcxz 4f\n"
+                         "3:\n\t"
+                         XINT_HW_MUL_STEP(0)
+                         XINT_HW_MUL_STEP(8)
+                         XINT_HW_MUL_STEP(16)
+                         XINT_HW_MUL_STEP(24)
+                         "lea 32(%[a]), %[a]\n\t"
+                         "lea 32(%[out]), %[out]\n\t"
+                         "lea -1(%[count]), %[count]\n\t"
+                         "jrcxz 4f\n\t"
+                         "jmp 3b\n"
+                         "4:\n\t"
+                         "mov $0, %k[lo]\n\t"
+                         "adcx %[lo], %[prev]"
+                         : [out] "+r" (out),
+                           [a] "+r" (a),
+                           [count] "+c" (count),
+                           [lo] "=&r" (lo),
+                           [hi] "=&r" (hi),
+                           [prev] "+r" (prev)
+                         : "d" (b),
+                           [blocks] "r" (blocks)
+                         : "cc", "memory");
+            return prev;
+        }
+
+
+        /*
+         * out[0, n) += a[0, n) * b
+         * `out` must not overlap `a`.
+         * @return the limb carried out of out[n - 1]
+         */
+        inline
+        limb_type
+        addmul_1(limb_type* out,
+                 const limb_type* a,
+                 std::size_t n,
+                 limb_type b)
+            noexcept
+        {
+            std::size_t count = n % 4;
+            const std::size_t blocks = n / 4;
+            limb_type lo;
+            limb_type hi;
+            limb_type prev = 0;
+            // note: xor clears both CF and OF
+            asm volatile("xor %k[lo], %k[lo]\n\t"
+                         "jrcxz 2f\n"
+                         "1:\n\t"
+                         XINT_HW_ADDMUL_STEP(0)
+                         "lea 8(%[a]), %[a]\n\t"
+                         "lea 8(%[out]), %[out]\n\t"
+                         "lea -1(%[count]), %[count]\n\t"
+                         "jrcxz 2f\n\t"
+                         "jmp 1b\n"
+                         "2:\n\t"
+                         "mov %[blocks], %[count]\n\t"
+                         "jrcxz 4f\n"
+                         "3:\n\t"
+                         XINT_HW_ADDMUL_STEP(0)
+                         XINT_HW_ADDMUL_STEP(8)
+                         XINT_HW_ADDMUL_STEP(16)
+                         XINT_HW_ADDMUL_STEP(24)
+                         "lea 32(%[a]), %[a]\n\t"
+                         "lea 32(%[out]), %[out]\n\t"
+                         "lea -1(%[count]), %[count]\n\t"
+                         "jrcxz 4f\n\t"
+                         "jmp 3b\n"
+                         "4:\n\t"
+                         "mov $0, %k[lo]\n\t"
+                         "adox %[lo], %[prev]\n\t"
+                         "adcx %[lo], %[prev]"
+                         : [out] "+r" (out),
+                           [a] "+r" (a),
+                           [count] "+c" (count),
+                           [lo] "=&r" (lo),
+                           [hi] "=&r" (hi),
+                           [prev] "+r" (prev)
+                         : "d" (b),
+                           [blocks] "r" (blocks)
+                         : "cc", "memory");
+            return prev;
+        }
+
+
+    } // namespace adx
+
+
+#undef XINT_HW_MUL_STEP
+#undef XINT_HW_ADDMUL_STEP
+
+#endif // XINT_HW_X86_64
+
+
+} // namespace xint::hw
+
+
+#endif
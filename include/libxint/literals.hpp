@@ -1,10 +1,15 @@
 #ifndef XINT_LITERALS_HPP
 #define XINT_LITERALS_HPP
 
+#include <algorithm> // max()
 #include <cmath> // floor, log2
-#include <string>
+#include <initializer_list>
+#include <stdexcept>
 #include <utility> // integer_sequence
 
+#include "eval-addition.hpp"
+#include "eval-multiplication.hpp"
+#include "eval-radix.hpp"
 #include "uint.hpp"
 
 
@@ -81,6 +86,12 @@ namespace xint {
             using data = std::integer_sequence<char, Cs...>;
         };
 
+        template<char... Cs>
+        struct parser<'0', 'X', Cs...> : parser<'0', 'x', Cs...> {};
+
+        template<char... Cs>
+        struct parser<'0', 'B', Cs...> : parser<'0', 'b', Cs...> {};
+
         template<char... Cs>
         struct parser<'0', Cs...> {
             static constexpr inline unsigned base = 8;
@@ -88,28 +99,89 @@ namespace xint {
         };
 
 
+        // digit separators don't count
         template<char... Cs>
-        std::string
-        extract(std::integer_sequence<char, Cs...>)
+        consteval
+        unsigned
+        count_digits(std::integer_sequence<char, Cs...>)
         {
-            return std::string{Cs...};
+            return ((Cs != '\'' ? 1u : 0u) + ... + 0u);
         }
 
+
+        template<typename Array,
+                 unsigned Base,
+                 char... Cs>
+        consteval
+        Array
+        parse_limbs(std::integer_sequence<char, Cs...>)
+        {
+            Array result{};
+            for (char c : std::initializer_list<char>{Cs...}) {
+                if (c == '\'')
+                    continue;
+                const limb_type d = static_cast<limb_type>(digit_value(c));
+                if (d >= Base)
+                    throw std::invalid_argument{"invalid digit in literal"};
+                // can't overflow, the type has enough bits for all digits
+                eval_mul_inplace_limb(result, Base);
+                eval_add_inplace_limb(result, d);
+            }
+            return result;
+        }
+
+
+        // Everything about a literal, computed at compile time.
+        template<char... Cs>
+        struct literal {
+
+            using parser_type = parser<Cs...>;
+            using data = parser_type::data;
+
+            static constexpr inline unsigned base = parser_type::base;
+
+            static constexpr inline unsigned bits =
+                std::max(1u, num_bits_v<base, count_digits(data{})>);
+
+            using type = uint<round_to_limb_v<bits>, false>;
+
+            static constexpr inline typename type::array_type limbs =
+                parse_limbs<typename type::array_type, base>(data{});
+
+        };
+
     } // detail
 
 
     namespace literals {
 
+        /*
+         * The limbs are always computed at compile time. When the result fits in local
+         * storage, the whole literal is a constant expression.
+         */
+
+        template<char... Cs>
+        requires (detail::literal<Cs...>::type::is_local)
+        consteval
+        auto
+        operator ""_uint()
+        {
+            using L = detail::literal<Cs...>;
+            typename L::type result;
+            result.limbs() = L::limbs;
+            return result;
+        }
+
+
         template<char... Cs>
+        requires (!detail::literal<Cs...>::type::is_local)
         auto
         operator ""_uint()
         {
-            using Parser = detail::parser<Cs...>;
-            using Data = Parser::data;
-            constexpr unsigned Base = Parser::base;
-            constexpr unsigned bits = detail::num_bits_v<Base, Data::size()>;
-            using U = uint<detail::round_to_limb_v<bits>, false>;
-            return U{detail::extract(Data{}), Base};
+            using L = detail::literal<Cs...>;
+            typename L::type result;
+            result.limbs() = L::limbs;
+            return result;
         }
 
     }
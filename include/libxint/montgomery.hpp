@@ -0,0 +1,158 @@
+#ifndef XINT_MONTGOMERY_HPP
+#define XINT_MONTGOMERY_HPP
+
+#include <array>
+#include <stdexcept>
+#include <type_traits>
+
+#include "eval-bits.hpp"
+#include "eval-montgomery.hpp"
+#include "stdlib.hpp"
+#include "traits.hpp"
+#include "uint.hpp"
+
+
+namespace xint {
+
+
+    /*
+     * Context for modular arithmetic in Montgomery form, for a fixed odd modulus m.
+     *
+     * A value x is represented as x * R mod m, where R = 2^U::num_bits. The
+     * multiplication of two such values only needs multiplications and additions,
+     * no division. Convert with to_mont() and from_mont(); all other member functions
+     * take and return values in Montgomery form.
+     *
+     * With `ConstantTime`, mul() and sqr() don't have any branch that depends on the
+     * values; the modulus itself is not protected.
+     */
+    template<unsigned_integral U,
+             bool ConstantTime = false>
+    class montgomery {
+
+        /*
+         * Scratch space for eval_mont_mul(). It follows U: on the stack when U is local,
+         * so it's at most 2 * XINT_MAX_LOCAL_BYTES plus a limb, otherwise on the heap.
+         */
+        using scratch_type = std::conditional_t<U::is_local,
+                                                std::array<limb_type, 2 * U::num_limbs + 1>,
+                                                uint<2 * U::num_bits + limb_bits>>;
+
+        static
+        auto&
+        scratch_limbs(scratch_type& t)
+            noexcept(U::is_local)
+        {
+            if constexpr (U::is_local)
+                return t;
+            else
+                return t.limbs();
+        }
+
+
+        U m_;
+        U r2_;    // R^2 mod m
+        U one_;   // R mod m
+        limb_type m_inv_;
+
+    public:
+
+        using value_type = U;
+
+
+        explicit
+        montgomery(const U& m) :
+            m_{m}
+        {
+            if (!(m.limb(0) & 1))
+                throw std::domain_error{"Montgomery modulus must be odd"};
+
+            m_inv_ = eval_mont_inverse(m.limb(0));
+
+            // note: R^2 needs two times the bits, plus one
+            uint<2 * U::num_bits + limb_bits> r2 = 0;
+            r2.limb(2 * U::num_limbs) = 1;
+            r2_ = div(r2, m_).second;
+
+            one_ = from_mont(r2_);
+        }
+
+
+        const U& modulus() const noexcept { return m_; }
+
+        // 1 in Montgomery form
+        const U& one() const noexcept { return one_; }
+
+
+        // x * R mod m
+        U
+        to_mont(const U& x)
+            const
+        {
+            return mul(x, r2_);
+        }
+
+
+        // x / R mod m
+        U
+        from_mont(const U& x)
+            const
+        {
+            U one = 1;
+            return mul(x, one);
+        }
+
+
+        // a * b / R mod m
+        U
+        mul(const U& a,
+            const U& b)
+            const
+        {
+            U result;
+            scratch_type t;
+            eval_mont_mul<ConstantTime>(result.limbs(),
+                                        b.limbs(),
+                                        a.limbs(),
+                                        m_.limbs(),
+                                        m_inv_,
+                                        scratch_limbs(t));
+            return result;
+        }
+
+
+        U
+        sqr(const U& a)
+            const
+        {
+            return mul(a, a);
+        }
+
+
+        // x^y, with x and the result in Montgomery form
+        template<unsigned_integral E>
+        U
+        pow(const U& x,
+            const E& y)
+            const
+        {
+            return detail::pow_sliding_window(one_,
+                                              x,
+                                              y,
+                                              [this](const U& a, const U& b) -> U
+                                              {
+                                                  return mul(a, b);
+                                              },
+                                              [this](const U& a) -> U
+                                              {
+                                                  return sqr(a);
+                                              });
+        }
+
+    };
+
+
+}
+
+
+#endif
@@ -2,6 +2,7 @@
 #define XINT_UINT_OPERATORS_HPP
 
 #include <algorithm>
+#include <array>
 #include <compare>
 #include <cstdlib> // aborT()
 #include <concepts>
@@ -11,6 +12,7 @@
 #include <stdexcept>
 #include <string>
 #include <type_traits>
+#include <utility> // move(), pair
 
 #include "eval-addition.hpp"
 #include "eval-assignment.hpp"
@@ -32,6 +34,160 @@
 namespace xint {
 
 
+    namespace detail {
+
+        // temporary storage for eval_mul_karatsuba(), for N-limb operands
+        template<std::size_t N>
+        using karatsuba_buffer_t = uint<(2 * N + karatsuba_scratch_size(N)) * limb_bits>;
+
+
+        template<unsigned_integral UA,
+                 unsigned_integral UB>
+        inline constexpr bool use_karatsuba_v = UA::num_limbs == UB::num_limbs
+                                                && UA::num_limbs >= karatsuba_mul_threshold;
+
+
+        // full product of two N-limb operands, for hw::mul_n(); always on the stack
+        template<std::size_t N>
+        using product_buffer_t = std::array<limb_type, 2 * N>;
+
+
+        // operands that go through hw::mul_n(), when the backend has it
+        template<unsigned_integral UA,
+                 unsigned_integral UB>
+        inline constexpr bool use_mul_n_v = hw::has_mul_n
+                                            && UA::num_limbs == UB::num_limbs
+                                            && UA::num_limbs >= hw::simd::min_limbs
+                                            && UA::num_limbs <= hw::simd::max_limbs;
+
+
+        /*
+         * True if a * b fits in n limbs. hw::mul_n() always computes the full product, so
+         * it's only used when none of it is thrown away.
+         */
+        template<unsigned_integral UA,
+                 unsigned_integral UB>
+        bool
+        product_fits(const UA& a,
+                     const UB& b,
+                     std::size_t n)
+            noexcept
+        {
+            return hw::simd::significant_limbs(std::ranges::data(a.limbs()), UA::num_limbs)
+                 + hw::simd::significant_limbs(std::ranges::data(b.limbs()), UB::num_limbs)
+                <= n;
+        }
+
+
+        // operands with the same number of limbs use the eval_*_fixed() kernels
+        template<unsigned_integral UA,
+                 unsigned_integral UB>
+        inline constexpr bool use_fixed_v = UA::num_limbs == UB::num_limbs;
+
+
+        template<unsigned_integral UA,
+                 unsigned_integral UB>
+        inline constexpr bool use_fixed_mul_v = use_fixed_v<UA, UB>
+                                                && UA::num_limbs <= utils::unroll_limbs;
+
+
+        // a += b
+        template<unsigned_integral UA,
+                 unsigned_integral UB>
+        constexpr
+        bool
+        add_inplace(UA& a,
+                    const UB& b)
+            noexcept
+        {
+            if constexpr (use_fixed_v<UA, UB>)
+                return eval_add_fixed(a.limbs(), a.limbs(), b.limbs());
+            else
+                return eval_add_inplace(a.limbs(), b.limbs());
+        }
+
+
+        // a -= b
+        template<unsigned_integral UA,
+                 unsigned_integral UB>
+        constexpr
+        bool
+        sub_inplace(UA& a,
+                    const UB& b)
+            noexcept
+        {
+            if constexpr (use_fixed_v<UA, UB>)
+                return eval_sub_fixed(a.limbs(), a.limbs(), b.limbs());
+            else
+                return eval_sub_inplace(a.limbs(), b.limbs());
+        }
+
+
+        // out = a * a, using the best kernel for the operand size
+        template<unsigned_integral U>
+        bool
+        sqr(limb_range auto&& out,
+            const U& a)
+            noexcept(!use_karatsuba_v<U, U>
+                     || noexcept(karatsuba_buffer_t<U::num_limbs>{}))
+        {
+            if constexpr (use_mul_n_v<U, U>)
+                if (hw::fast_mul_n() && product_fits(a, a, std::ranges::size(out))) {
+                    product_buffer_t<U::num_limbs> prod;
+                    hw::mul_n(prod.data(),
+                              std::ranges::data(a.limbs()),
+                              std::ranges::data(a.limbs()),
+                              U::num_limbs);
+                    return eval_assign(out, prod);
+                }
+
+            if constexpr (use_karatsuba_v<U, U>) {
+                karatsuba_buffer_t<U::num_limbs> buf;
+                return eval_sqr_karatsuba(out, a.limbs(), buf.limbs());
+            } else
+                return eval_sqr_simple(out, a.limbs());
+        }
+
+
+        // out = a * b, using the best kernel for the operands size
+        template<unsigned_integral UA,
+                 unsigned_integral UB>
+        bool
+        mul(limb_range auto&& out,
+            const UA& a,
+            const UB& b)
+            noexcept(!use_karatsuba_v<UA, UB>
+                     || noexcept(karatsuba_buffer_t<UA::num_limbs>{}))
+        {
+            if constexpr (std::same_as<UA, UB>)
+                if (&a == &b)
+                    return sqr(out, a);
+
+            if constexpr (use_mul_n_v<UA, UB>)
+                if (hw::fast_mul_n() && product_fits(a, b, std::ranges::size(out))) {
+                    product_buffer_t<UA::num_limbs> prod;
+                    hw::mul_n(prod.data(),
+                              std::ranges::data(a.limbs()),
+                              std::ranges::data(b.limbs()),
+                              UA::num_limbs);
+                    return eval_assign(out, prod);
+                }
+
+            if constexpr (use_karatsuba_v<UA, UB>) {
+                karatsuba_buffer_t<UA::num_limbs> buf;
+                return eval_mul_karatsuba(out, a.limbs(), b.limbs(), buf.limbs());
+            } else if constexpr (use_fixed_mul_v<UA, UB>
+                                 && std::same_as<std::remove_cvref_t<decltype(out)>,
+                                                 typename UA::array_type>)
+                return eval_mul_fixed(out, a.limbs(), b.limbs());
+            else
+                return eval_mul_simple(out, a.limbs(), b.limbs());
+        }
+
+    } // namespace detail
+
+
+
     // Division; not an operator, but more handy than the / and % operators
 
     template<unsigned_integral UA,
@@ -112,7 +268,7 @@ namespace xint {
     requires(Safe || !Safe2)
     uint<Bits, Safe>&
     uint<Bits, Safe>::operator =(const uint<Bits2, Safe2>& other)
-        noexcept((Bits == Bits2) || (!Safe && !Safe2))
+        noexcept(is_local && ((Bits == Bits2) || (!Safe && !Safe2)))
     {
         if constexpr (Bits != Bits2) {
             bool overflow = eval_assign(limbs(), other.limbs());
@@ -135,7 +291,7 @@ namespace xint {
                 const UB& b)
         noexcept(!any_are_safe_v<UA, UB>)
     {
-        bool overflow = eval_add_inplace(a.limbs(), b.limbs());
+        bool overflow = detail::add_inplace(a, b);
         if constexpr (any_are_safe_v<UA, UB>)
             if (overflow)
                 throw std::overflow_error{"overflow in +="};
@@ -162,7 +318,7 @@ namespace xint {
                 const UB& b)
         noexcept(!any_are_safe_v<UA, UB>)
     {
-        bool overflow = eval_sub_inplace(a.limbs(), b.limbs());
+        bool overflow = detail::sub_inplace(a, b);
         if constexpr (any_are_safe_v<UA, UB>)
             if (overflow)
                 throw std::overflow_error{"overflow in -="};
@@ -190,10 +346,12 @@ namespace xint {
     UA&
     operator *=(UA& a,
                 const UB& b)
-        noexcept(noexcept(UA{}) && !any_are_safe_v<UA, UB>)
+        noexcept(noexcept(UA{})
+                 && noexcept(detail::mul(a.limbs(), a, b))
+                 && !any_are_safe_v<UA, UB>)
     {
         UA c;
-        bool overflow = eval_mul_simple(c.limbs(), a.limbs(), b.limbs());
+        bool overflow = detail::mul(c.limbs(), a, b);
         if constexpr (any_are_safe_v<UA, UB>)
             if (overflow)
                 throw std::overflow_error{"overflow in *="};
@@ -430,15 +588,35 @@ namespace xint {
         noexcept(noexcept(std::common_type_t<UA, UB>{}) && !any_are_safe_v<UA, UB>)
     {
         std::common_type_t<UA, UB> result;
-        bool overflow = eval_add(result.limbs(),
-                                 a.limbs(),
-                                 b.limbs());
+        bool overflow;
+        if constexpr (detail::use_fixed_v<UA, UB>)
+            overflow = eval_add_fixed(result.limbs(), a.limbs(), b.limbs());
+        else
+            overflow = eval_add(result.limbs(), a.limbs(), b.limbs());
         if constexpr (any_are_safe_v<UA, UB>)
             if (overflow)
                 throw std::overflow_error{"overflow in +"};
         return result;
     }
 
+    // a + b, when a is a temporary on the heap: reuse its buffer
+    template<unsigned_integral UA,
+             unsigned_integral UB>
+    requires (std::same_as<UA, std::remove_cvref_t<UA>>
+              && std::same_as<std::common_type_t<UA, UB>, UA>
+              && !UA::is_local)
+    UA
+    operator +(UA&& a,
+               const UB& b)
+        noexcept(!any_are_safe_v<UA, UB>)
+    {
+        bool overflow = detail::add_inplace(a, b);
+        if constexpr (any_are_safe_v<UA, UB>)
+            if (overflow)
+                throw std::overflow_error{"overflow in +"};
+        return std::move(a);
+    }
+
     template<unsigned_integral U,
              std::integral I>
     std::common_type_t<U, I>
@@ -469,15 +647,35 @@ namespace xint {
         noexcept(noexcept(std::common_type_t<UA, UB>{}) && !any_are_safe_v<UA, UB>)
     {
         std::common_type_t<UA, UB> result;
-        bool underflow = eval_sub(result.limbs(),
-                                  a.limbs(),
-                                  b.limbs());
+        bool underflow;
+        if constexpr (detail::use_fixed_v<UA, UB>)
+            underflow = eval_sub_fixed(result.limbs(), a.limbs(), b.limbs());
+        else
+            underflow = eval_sub(result.limbs(), a.limbs(), b.limbs());
         if constexpr (any_are_safe_v<UA, UB>)
             if (underflow)
                 throw std::overflow_error{"overflow in -"};
         return result;
     }
 
+    // a - b, when a is a temporary on the heap: reuse its buffer
+    template<unsigned_integral UA,
+             unsigned_integral UB>
+    requires (std::same_as<UA, std::remove_cvref_t<UA>>
+              && std::same_as<std::common_type_t<UA, UB>, UA>
+              && !UA::is_local)
+    UA
+    operator -(UA&& a,
+               const UB& b)
+        noexcept(!any_are_safe_v<UA, UB>)
+    {
+        bool underflow = detail::sub_inplace(a, b);
+        if constexpr (any_are_safe_v<UA, UB>)
+            if (underflow)
+                throw std::overflow_error{"overflow in -"};
+        return std::move(a);
+    }
+
     template<unsigned_integral U,
              std::integral I>
     std::common_type_t<U, I>
@@ -505,12 +703,12 @@ namespace xint {
     std::common_type_t<UA, UB>
     operator *(const UA& a,
                const UB& b)
-        noexcept(noexcept(std::common_type_t<UA, UB>{}) && !any_are_safe_v<UA, UB>)
+        noexcept(noexcept(std::common_type_t<UA, UB>{})
+                 && noexcept(detail::mul(a.limbs(), a, b))
+                 && !any_are_safe_v<UA, UB>)
     {
         std::common_type_t<UA, UB> result;
-        bool overflow = eval_mul_simple(result.limbs(),
-                                        a.limbs(),
-                                        b.limbs());
+        bool overflow = detail::mul(result.limbs(), a, b);
         if constexpr (any_are_safe_v<UA, UB>)
             if (overflow)
                 throw std::overflow_error{"overflow in *"};
@@ -518,6 +716,82 @@ namespace xint {
     }
 
 
+    // a * a
+    template<unsigned_integral U>
+    U
+    sqr(const U& a)
+        noexcept(noexcept(U{})
+                 && noexcept(detail::sqr(a.limbs(), a))
+                 && !is_safe_v<U>)
+    {
+        U result;
+        bool overflow = detail::sqr(result.limbs(), a);
+        if constexpr (is_safe_v<U>)
+            if (overflow)
+                throw std::overflow_error{"overflow in sqr()"};
+        return result;
+    }
+
+
+    // a * b, with all the bits of the product
+    template<unsigned_integral UA,
+             unsigned_integral UB>
+    uint<UA::num_bits + UB::num_bits, any_are_safe_v<UA, UB>>
+    mul_wide(const UA& a,
+             const UB& b)
+        noexcept(noexcept(uint<UA::num_bits + UB::num_bits>{})
+                 && noexcept(detail::mul(a.limbs(), a, b)))
+    {
+        uint<UA::num_bits + UB::num_bits, any_are_safe_v<UA, UB>> result;
+        detail::mul(result.limbs(), a, b);
+        return result;
+    }
+
+
+    // the upper half of a * b: (a * b) >> N, where N is the width of the result
+    template<unsigned_integral UA,
+             unsigned_integral UB>
+    std::common_type_t<UA, UB>
+    mul_hi(const UA& a,
+           const UB& b)
+        noexcept(noexcept(uint<UA::num_bits + UB::num_bits>{})
+                 && noexcept(std::common_type_t<UA, UB>{})
+                 && noexcept(detail::mul(a.limbs(), a, b)))
+    {
+        using U = std::common_type_t<UA, UB>;
+        using W = uint<UA::num_bits + UB::num_bits>;
+        W t;
+        U result;
+        if constexpr (detail::use_karatsuba_v<UA, UB>) {
+            // Karatsuba's full product is cheaper than the schoolbook half
+            detail::mul(t.limbs(), a, b);
+            eval_assign(result.limbs(), t.limbs() | std::views::drop(U::num_limbs));
+        } else
+            eval_mul_hi(result.limbs(), a.limbs(), b.limbs(), t.limbs());
+        return result;
+    }
+
+
+    /*
+     * a * b + c, with all the bits of the result
+     * It never overflows: c must not be wider than the widest of a and b.
+     */
+    template<unsigned_integral UA,
+             unsigned_integral UB,
+             unsigned_integral UC>
+    requires (UC::num_bits <= std::max(UA::num_bits, UB::num_bits))
+    uint<UA::num_bits + UB::num_bits, any_are_safe_v<UA, UB, UC>>
+    mul_add(const UA& a,
+            const UB& b,
+            const UC& c)
+        noexcept(noexcept(uint<UA::num_bits + UB::num_bits>{}))
+    {
+        uint<UA::num_bits + UB::num_bits, any_are_safe_v<UA, UB, UC>> result;
+        eval_mul_add(result.limbs(), a.limbs(), b.limbs(), c.limbs());
+        return result;
+    }
+
+
     template<unsigned_integral U,
              std::integral I>
     std::common_type_t<U, I>
@@ -527,9 +801,11 @@ namespace xint {
     {
         if constexpr (sizeof(I) <= sizeof(limb_type)) {
             std::common_type_t<U, I> result;
-            bool overflow = eval_mul_limb(result.limbs(),
-                                          a.limbs(),
-                                          b);
+            bool overflow;
+            if constexpr (std::common_type_t<U, I>::num_limbs == U::num_limbs)
+                overflow = eval_mul_limb_fixed(result.limbs(), a.limbs(), b);
+            else
+                overflow = eval_mul_limb(result.limbs(), a.limbs(), b);
             if constexpr (is_safe_v<U>)
                 if (overflow)
                     throw std::overflow_error{"overflow in *"};
@@ -700,6 +976,7 @@ namespace xint {
 
     template<unsigned_integral UA,
              unsigned_integral UB>
+    constexpr
     bool
     operator ==(const UA& a,
                 const UB& b)
@@ -714,6 +991,7 @@ namespace xint {
     // TODO: check if this overload is necessary
     template<unsigned_integral U,
              std::integral I>
+    constexpr
     bool
     operator ==(const U& a,
                 I b)
@@ -725,6 +1003,7 @@ namespace xint {
 
     template<unsigned_integral U,
              std::integral I>
+    constexpr
     bool
     operator ==(I a,
                 const U& b)
@@ -736,6 +1015,7 @@ namespace xint {
 
     template<unsigned_integral UA,
              unsigned_integral UB>
+    constexpr
     std::strong_ordering
     operator <=>(const UA& a,
                  const UB& b)
@@ -754,6 +1034,7 @@ namespace xint {
 
     template<unsigned_integral U,
              std::integral I>
+    constexpr
     std::strong_ordering
     operator <=>(const U& a,
                  I b)
@@ -765,6 +1046,7 @@ namespace xint {
 
     template<std::integral I,
              unsigned_integral U>
+    constexpr
     std::strong_ordering
     operator <=>(I a,
                  const U& b)
@@ -787,7 +1069,7 @@ namespace xint {
     operator >>(std::istream& in,
                 U& n)
     {
-        std::ostream::sentry s{in};
+        std::istream::sentry s{in};
         if (s)
             eval_input(in, n);
         return in;
@@ -4,6 +4,7 @@
 #include <algorithm>
 #include <random>
 
+#include "montgomery.hpp"
 #include "uint.hpp"
 #include "random.hpp"
 #include "stdlib.hpp"
@@ -44,10 +45,15 @@ namespace xint {
         const unsigned s = countr_zero(minus_one);
         const U k = minus_one >> s;
 
-        auto witness = [&n, &minus_one, &k, s](const U& a) -> bool
+        // all witnesses share the same modulus, so they work in Montgomery form
+        const montgomery<U> mont{n};
+        const U& mont_one = mont.one();
+        const U mont_minus_one = mont.to_mont(minus_one);
+
+        auto witness = [&mont, &mont_one, &mont_minus_one, &k, s](const U& a) -> bool
         {
-            auto x = powm(a, k, n);
-            if (x == 1 || x == minus_one)
+            auto x = mont.pow(mont.to_mont(a), k);
+            if (x == mont_one || x == mont_minus_one)
                 return true;
 
             /*
@@ -63,8 +69,8 @@ namespace xint {
              * Both possibilities imply that p is not prime.
              */
             for (unsigned i = 0; i < s - 1;  ++i) {
-                x = x * x % n;
-                if (x == minus_one)
+                x = mont.sqr(x);
+                if (x == mont_minus_one)
                     return true;
             }
             return false;
@@ -0,0 +1,469 @@
+#ifndef XINT_SIMD_HPP
+#define XINT_SIMD_HPP
+
+#include <algorithm> // fill_n()
+#include <cassert>
+#include <cstddef> // std::size_t
+
+#include "intrinsics.hpp"
+#include "types.hpp"
+
+
+/*
+ * Vector multiplication kernels, for 64-bit limbs on x86-64.
+ *
+ * The limbs are split into smaller digits, one per 64-bit lane, so the lanes can
+ * accumulate many products before any carry has to be propagated:
+ *
+ *   - hw::avx512ifma: 52-bit digits, 8 lanes, multiplied with vpmadd52luq/vpmadd52huq.
+ *     It has mul_n(), the full product, and mont_mul().
+ *   - hw::avx2: 26-bit digits, 4 lanes, multiplied with vpmuludq. It only has
+ *     mont_mul(): a 26-bit digit product is too little work for a plain product to
+ *     beat the scalar rows, only the Montgomery reduction gains from the vectors.
+ *
+ * mont_mul() uses the same R = 2^(64 * n) as the scalar code, so the values in Montgomery
+ * form don't change. They're only worth it for large operands, from `simd::min_limbs` to
+ * `simd::max_limbs` limbs (from `simd::avx2_min_limbs` for hw::avx2, which gains less);
+ * the scratch space is on the stack.
+ *
+ * The functions are compiled with the target attribute, so no -m flag is needed, but
+ * they're opt-in: define XINT_USE_SIMD=1 to add them to the backends in dispatch.hpp,
+ * which checks the CPU before using them.
+ */
+
+
+#ifndef XINT_USE_SIMD
+#define XINT_USE_SIMD 0
+#endif
+
+
+#if XINT_USE_SIMD && defined(XINT_HW_X86_64)
+#define XINT_HW_SIMD 1
+#include <immintrin.h>
+#endif
+
+
+#ifndef XINT_SIMD_MIN_LIMBS
+#define XINT_SIMD_MIN_LIMBS 32
+#endif
+
+#ifndef XINT_SIMD_AVX2_MIN_LIMBS
+#define XINT_SIMD_AVX2_MIN_LIMBS 64
+#endif
+
+
+namespace xint::hw::simd {
+
+    // operands with fewer limbs than this stay on the scalar rows
+    inline constexpr std::size_t min_limbs = XINT_SIMD_MIN_LIMBS;
+
+    // same for hw::avx2::mont_mul(); below 4096 bits its gain over the rows is too uneven
+    inline constexpr std::size_t avx2_min_limbs = XINT_SIMD_AVX2_MIN_LIMBS;
+
+    // the largest operands the vector kernels handle (8192 bits)
+    inline constexpr std::size_t max_limbs = 128;
+
+    static_assert(min_limbs <= max_limbs);
+    static_assert(avx2_min_limbs <= max_limbs);
+
+
+    // number of Bits-bit digits needed for n limbs
+    template<unsigned Bits>
+    constexpr
+    std::size_t
+    num_digits(std::size_t n)
+        noexcept
+    {
+        return (n * 64 + Bits - 1) / Bits;
+    }
+
+
+    // same as num_digits(), rounded up to whole vectors
+    template<unsigned Bits,
+             std::size_t Lanes>
+    constexpr
+    std::size_t
+    padded_digits(std::size_t n)
+        noexcept
+    {
+        return (num_digits<Bits>(n) + Lanes - 1) / Lanes * Lanes;
+    }
+
+
+    // number of limbs in a[0, n), without the leading zeros
+    inline
+    std::size_t
+    significant_limbs(const limb_type* a,
+                      std::size_t n)
+        noexcept
+    {
+        while (n && !a[n - 1])
+            --n;
+        return n;
+    }
+
+
+#ifdef XINT_HW_SIMD
+
+    /*
+     * Splits a[0, n) << shift into k Bits-bit digits.
+     * Notes:
+     *     - `shift` must be less than `Bits`, and the shifted value must fit in k digits.
+     *     - `out[k, padded)` is set to zero.
+     */
+    template<unsigned Bits>
+    void
+    to_digits(limb_type* out,
+              std::size_t k,
+              std::size_t padded,
+              const limb_type* a,
+              std::size_t n,
+              unsigned shift)
+        noexcept
+    {
+        constexpr limb_type mask = (limb_type{1} << Bits) - 1;
+        assert(shift < Bits);
+
+        // the next bits of a, starting with `shift` zeros
+        wide_limb_type bits = 0;
+        unsigned num_bits = shift;
+        std::size_t i = 0;
+        for (std::size_t d = 0; d < k; ++d) {
+            if (num_bits < Bits) {
+                if (i < n)
+                    bits |= wide_limb_type{a[i++]} << num_bits;
+                num_bits += 64;
+            }
+            out[d] = static_cast<limb_type>(bits) & mask;
+            bits >>= Bits;
+            num_bits -= Bits;
+        }
+        std::fill_n(out + k, padded - k, 0);
+    }
+
+
+    /*
+     * out[0, m) = the sum of digit(p) * 2^(Bits * p), for p in [0, k)
+     * The digits don't need to be normalized, the carries are propagated here; whatever
+     * doesn't fit in `out` is dropped.
+     */
+    template<unsigned Bits>
+    void
+    from_digits(limb_type* out,
+                std::size_t m,
+                std::size_t k,
+                auto digit)
+        noexcept
+    {
+        constexpr limb_type mask = (limb_type{1} << Bits) - 1;
+
+        wide_limb_type carry = 0;
+        // the next bits to be stored in out
+        wide_limb_type bits = 0;
+        unsigned num_bits = 0;
+        std::size_t o = 0;
+        for (std::size_t p = 0; o < m; ++p) {
+            if (p < k)
+                carry += digit(p);
+            bits |= wide_limb_type{static_cast<limb_type>(carry) & mask} << num_bits;
+            carry >>= Bits;
+            num_bits += Bits;
+            if (num_bits >= 64) {
+                out[o++] = static_cast<limb_type>(bits);
+                bits >>= 64;
+                num_bits -= 64;
+            }
+        }
+    }
+
+#endif // XINT_HW_SIMD
+
+} // namespace xint::hw::simd
+
+
+#ifdef XINT_HW_SIMD
+
+namespace xint::hw {
+
+
+    /*
+     * Both backends use the same layout: `x` holds the digits of the running sum, from
+     * the current row on. Each row adds its products and shifts x down by one digit in
+     * the same pass, so the loads and stores stay aligned; the digit shifted out goes
+     * into `carry`, which holds the rest of that column.
+     */
+
+
+    /*
+     * The low half of a product of 52-bit digits is added before the shift, the high
+     * half after it, since it belongs to the next digit. A lane gets at most 4 halves
+     * per row, and there are at most 158 rows, so it can't overflow.
+     */
+    namespace avx512ifma {
+
+        inline constexpr unsigned digit_bits = 52;
+        inline constexpr std::size_t lanes = 8;
+        inline constexpr limb_type digit_mask = (limb_type{1} << digit_bits) - 1;
+        // with room for one more vector of zeros
+        inline constexpr std::size_t max_digits = simd::padded_digits<digit_bits,
+                                                                      lanes>(simd::max_limbs)
+                                                  + lanes;
+
+
+        // lanes 1 to 7 of lo, then lane 0 of hi
+        [[gnu::target("avx512f")]]
+        inline
+        __m512i
+        shift_down(__m512i hi,
+                   __m512i lo)
+            noexcept
+        {
+            // note: the unmasked _mm512_alignr_epi64() makes GCC warn about its undefined source
+            return _mm512_maskz_alignr_epi64(0xff, hi, lo, 1);
+        }
+
+
+        // out[0, 2n) = a[0, n) * b[0, n)
+        [[gnu::target("avx512f,avx512ifma")]]
+        inline
+        void
+        mul_n(limb_type* out,
+              const limb_type* a,
+              const limb_type* b,
+              std::size_t n)
+            noexcept
+        {
+            assert(n <= simd::max_limbs);
+            // the leading zeros are skipped: a sets the row length, b the number of rows
+            const std::size_t na = simd::significant_limbs(a, n);
+            const std::size_t nb = simd::significant_limbs(b, n);
+            if (!na || !nb) {
+                std::fill_n(out, 2 * n, 0);
+                return;
+            }
+            const std::size_t ka = simd::num_digits<digit_bits>(na);
+            const std::size_t kb = simd::num_digits<digit_bits>(nb);
+            const std::size_t kp = simd::padded_digits<digit_bits, lanes>(na);
+
+            alignas(64) limb_type da[max_digits];
+            alignas(64) limb_type db[max_digits];
+            alignas(64) limb_type x[max_digits];
+            // the digits shifted out of x
+            limb_type low[max_digits];
+            simd::to_digits<digit_bits>(da, ka, kp + lanes, a, na, 0);
+            simd::to_digits<digit_bits>(db, kb, kb, b, nb, 0);
+            std::fill_n(x, kp + lanes, 0);
+
+            limb_type carry = 0;
+            for (std::size_t i = 0; i < kb; ++i) {
+                const limb_type t0 = x[0] + carry + ((da[0] * db[i]) & digit_mask);
+                low[i] = t0 & digit_mask;
+                carry = t0 >> digit_bits;
+
+                const __m512i vb = _mm512_set1_epi64(static_cast<long long>(db[i]));
+                __m512i cur = _mm512_madd52lo_epu64(_mm512_load_si512(x),
+                                                    _mm512_load_si512(da),
+                                                    vb);
+                for (std::size_t j = 0; j < kp; j += lanes) {
+                    const __m512i h = _mm512_madd52hi_epu64(_mm512_setzero_si512(),
+                                                            _mm512_load_si512(da + j),
+                                                            vb);
+                    const std::size_t jn = j + lanes;
+                    const __m512i next = _mm512_madd52lo_epu64(_mm512_load_si512(x + jn),
+                                                               _mm512_load_si512(da + jn),
+                                                               vb);
+                    _mm512_store_si512(x + j,
+                                       _mm512_add_epi64(shift_down(next, cur), h));
+                    cur = next;
+                }
+            }
+
+            simd::from_digits<digit_bits>(out, 2 * n, kb + kp,
+                                          [&](std::size_t p) -> limb_type
+                                          {
+                                              if (p < kb)
+                                                  return low[p];
+                                              return x[p - kb] + (p == kb ? carry : 0);
+                                          });
+        }
+
+
+        /*
+         * t[n, 2n] = a * b / R, where R = 2^(64 * n); the result is less than 2m.
+         * Same contract as mont_mul_rows() in dispatch.hpp.
+         * The reduction divides by 2^52 per row, so a is shifted left by the difference
+         * between 52 * k and 64 * n first.
+         */
+        [[gnu::target("avx512f,avx512ifma")]]
+        inline
+        void
+        mont_mul(limb_type* t,
+                 const limb_type* a,
+                 const limb_type* b,
+                 const limb_type* m,
+                 limb_type m_inv,
+                 std::size_t n)
+            noexcept
+        {
+            assert(n <= simd::max_limbs);
+            const std::size_t k = simd::num_digits<digit_bits>(n);
+            const std::size_t kp = simd::padded_digits<digit_bits, lanes>(n);
+            const unsigned shift = static_cast<unsigned>(digit_bits * k - 64 * n);
+
+            alignas(64) limb_type da[max_digits];
+            alignas(64) limb_type db[max_digits];
+            alignas(64) limb_type dm[max_digits];
+            alignas(64) limb_type x[max_digits];
+            simd::to_digits<digit_bits>(da, k, kp + lanes, a, n, shift);
+            simd::to_digits<digit_bits>(db, k, kp, b, n, 0);
+            simd::to_digits<digit_bits>(dm, k, kp + lanes, m, n, 0);
+            std::fill_n(x, kp + lanes, 0);
+
+            limb_type carry = 0;
+            for (std::size_t i = 0; i < k; ++i) {
+                // q makes the digit shifted out zero
+                const limb_type t0 = x[0] + carry + ((da[0] * db[i]) & digit_mask);
+                const limb_type q = (t0 * m_inv) & digit_mask;
+                carry = (t0 + ((dm[0] * q) & digit_mask)) >> digit_bits;
+
+                const __m512i vb = _mm512_set1_epi64(static_cast<long long>(db[i]));
+                const __m512i vq = _mm512_set1_epi64(static_cast<long long>(q));
+                __m512i cur = _mm512_load_si512(x);
+                cur = _mm512_madd52lo_epu64(cur, _mm512_load_si512(da), vb);
+                cur = _mm512_madd52lo_epu64(cur, _mm512_load_si512(dm), vq);
+                for (std::size_t j = 0; j < kp; j += lanes) {
+                    __m512i h = _mm512_setzero_si512();
+                    h = _mm512_madd52hi_epu64(h, _mm512_load_si512(da + j), vb);
+                    h = _mm512_madd52hi_epu64(h, _mm512_load_si512(dm + j), vq);
+                    const std::size_t jn = j + lanes;
+                    __m512i next = _mm512_load_si512(x + jn);
+                    next = _mm512_madd52lo_epu64(next, _mm512_load_si512(da + jn), vb);
+                    next = _mm512_madd52lo_epu64(next, _mm512_load_si512(dm + jn), vq);
+                    _mm512_store_si512(x + j,
+                                       _mm512_add_epi64(shift_down(next, cur), h));
+                    cur = next;
+                }
+            }
+
+            simd::from_digits<digit_bits>(t + n, n + 1, kp,
+                                          [&](std::size_t p) -> limb_type
+                                          {
+                                              return x[p] + (p ? 0 : carry);
+                                          });
+        }
+
+    } // namespace avx512ifma
+
+
+    /*
+     * The products of 26-bit digits are exact, so there's no high half. A lane gets at
+     * most 2 products per row, and there are at most 316 rows.
+     */
+    namespace avx2 {
+
+        inline constexpr unsigned digit_bits = 26;
+        inline constexpr std::size_t lanes = 4;
+        inline constexpr limb_type digit_mask = (limb_type{1} << digit_bits) - 1;
+        // with room for one more vector of zeros
+        inline constexpr std::size_t max_digits = simd::padded_digits<digit_bits,
+                                                                      lanes>(simd::max_limbs)
+                                                  + lanes;
+
+
+        // lanes 1, 2 and 3 of v, then lane 0
+        [[gnu::target("avx2")]]
+        inline
+        __m256i
+        rotate(__m256i v)
+            noexcept
+        {
+            return _mm256_permute4x64_epi64(v, 0b00'11'10'01);
+        }
+
+
+        [[gnu::target("avx2")]]
+        inline
+        __m256i
+        load(const limb_type* p)
+            noexcept
+        {
+            return _mm256_load_si256(reinterpret_cast<const __m256i*>(p));
+        }
+
+
+        // s + a * b, on the low 32 bits of the lanes of a and b
+        [[gnu::target("avx2")]]
+        inline
+        __m256i
+        mul_add(__m256i s,
+                __m256i a,
+                __m256i b)
+            noexcept
+        {
+            return _mm256_add_epi64(s, _mm256_mul_epu32(a, b));
+        }
+
+
+        // t[n, 2n] = a * b / R, like avx512ifma::mont_mul()
+        [[gnu::target("avx2")]]
+        inline
+        void
+        mont_mul(limb_type* t,
+                 const limb_type* a,
+                 const limb_type* b,
+                 const limb_type* m,
+                 limb_type m_inv,
+                 std::size_t n)
+            noexcept
+        {
+            assert(n <= simd::max_limbs);
+            const std::size_t k = simd::num_digits<digit_bits>(n);
+            const std::size_t kp = simd::padded_digits<digit_bits, lanes>(n);
+            const unsigned shift = static_cast<unsigned>(digit_bits * k - 64 * n);
+
+            alignas(32) limb_type da[max_digits];
+            alignas(32) limb_type db[max_digits];
+            alignas(32) limb_type dm[max_digits];
+            alignas(32) limb_type x[max_digits];
+            simd::to_digits<digit_bits>(da, k, kp + lanes, a, n, shift);
+            simd::to_digits<digit_bits>(db, k, kp, b, n, 0);
+            simd::to_digits<digit_bits>(dm, k, kp + lanes, m, n, 0);
+            std::fill_n(x, kp + lanes, 0);
+
+            limb_type carry = 0;
+            for (std::size_t i = 0; i < k; ++i) {
+                // q makes the digit shifted out zero
+                const limb_type t0 = x[0] + carry + da[0] * db[i];
+                const limb_type q = (t0 * m_inv) & digit_mask;
+                carry = (t0 + dm[0] * q) >> digit_bits;
+
+                const __m256i vb = _mm256_set1_epi64x(static_cast<long long>(db[i]));
+                const __m256i vq = _mm256_set1_epi64x(static_cast<long long>(q));
+                __m256i cur = rotate(mul_add(mul_add(load(x), load(da), vb), load(dm), vq));
+                for (std::size_t j = 0; j < kp; j += lanes) {
+                    const std::size_t jn = j + lanes;
+                    const __m256i next = rotate(mul_add(mul_add(load(x + jn), load(da + jn), vb),
+                                                        load(dm + jn),
+                                                        vq));
+                    _mm256_store_si256(reinterpret_cast<__m256i*>(x + j),
+                                       _mm256_blend_epi32(cur, next, 0b1100'0000));
+                    cur = next;
+                }
+            }
+
+            simd::from_digits<digit_bits>(t + n, n + 1, kp,
+                                          [&](std::size_t p) -> limb_type
+                                          {
+                                              return x[p] + (p ? 0 : carry);
+                                          });
+        }
+
+    } // namespace avx2
+
+
+} // namespace xint::hw
+
+#endif // XINT_HW_SIMD
+
+
+#endif
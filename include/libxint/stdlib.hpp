@@ -2,11 +2,13 @@
 #define XINT_STDLIB_HPP
 
 #include <algorithm> // min()
+#include <array>
 #include <bit>
 #include <limits>
 #include <string>
 #include <type_traits>
 #include <utility> // swap(), pair
+#include <vector>
 
 #include "eval-bits.hpp"
 #include "limits.hpp"
@@ -238,24 +240,125 @@ namespace xint {
     }
 
 
-   template<xint::unsigned_integral U>
-   U
-   powm(const U& x,
-        const U& y,
-        const U& m)
-   {
-       U r = 1;
-       auto xx = x;
-       const unsigned y_width = bit_width(y);
-       for (unsigned b = 0; b < y_width; ++b) {
-           if (xint::eval_bit_get(y.limbs(), b))
-               r = r * xx % m;
-           xx = xx * xx % m;
-       }
-       return r;
-   }
+    namespace detail {
+
+        // bits per window for an exponent with `exp_bits` bits, same table as OpenSSL
+        constexpr
+        unsigned
+        pow_window_bits(unsigned exp_bits)
+            noexcept
+        {
+            if (exp_bits > 671)
+                return 6;
+            if (exp_bits > 239)
+                return 5;
+            if (exp_bits > 79)
+                return 4;
+            if (exp_bits > 23)
+                return 3;
+            return 1;
+        }
+
+
+        /*
+         * x^y, by left-to-right sliding-window exponentiation.
+         * `mul(a, b)` and `sqr(a)` do the (modular) multiplication, `one` is the identity.
+         * Only the odd powers x, x^3, ..., x^(2^w - 1) are precomputed.
+         */
+        template<typename T,
+                 unsigned_integral E,
+                 typename Mul,
+                 typename Sqr>
+        T
+        pow_sliding_window(const T& one,
+                           const T& x,
+                           const E& y,
+                           Mul mul,
+                           Sqr sqr)
+        {
+            const unsigned y_width = eval_bit_width(y.limbs());
+            if (!y_width)
+                return one;
+
+            const unsigned w = pow_window_bits(y_width);
+            const std::size_t count = std::size_t{1} << (w - 1);
+
+            /*
+             * Local values go in an array sized for the widest window any E can get.
+             * Heap values would all be allocated by that array, so only `count` of them
+             * are made, in a vector.
+             */
+            std::conditional_t<T::is_local,
+                               std::array<T, std::size_t{1} << (pow_window_bits(E::num_bits) - 1)>,
+                               std::vector<T>> odd_powers;
+            if constexpr (T::is_local)
+                odd_powers[0] = x;
+            else {
+                odd_powers.reserve(count);
+                odd_powers.push_back(x);
+            }
+            if (w > 1) {
+                const T x2 = sqr(x);
+                for (std::size_t i = 1; i < count; ++i)
+                    if constexpr (T::is_local)
+                        odd_powers[i] = mul(odd_powers[i - 1], x2);
+                    else
+                        odd_powers.push_back(mul(odd_powers[i - 1], x2));
+            }
+
+            T r = one;
+            bool first = true;
+            for (unsigned i = y_width; i > 0;) {
+                if (!eval_bit_get(y.limbs(), i - 1)) {
+                    r = sqr(r);
+                    --i;
+                    continue;
+                }
+
+                // the window is bits [j, i), it must end on a set bit
+                unsigned j = i > w ? i - w : 0;
+                while (!eval_bit_get(y.limbs(), j))
+                    ++j;
+
+                unsigned val = 0;
+                for (unsigned k = i; k > j; --k)
+                    val = val << 1 | eval_bit_get(y.limbs(), k - 1);
+
+                if (first) {
+                    r = odd_powers[val >> 1];
+                    first = false;
+                } else {
+                    for (unsigned k = j; k < i; ++k)
+                        r = sqr(r);
+                    r = mul(r, odd_powers[val >> 1]);
+                }
+                i = j;
+            }
+            return r;
+        }
+
+    } // namespace detail
 
 
+    template<xint::unsigned_integral U>
+    U
+    powm(const U& x,
+         const U& y,
+         const U& m)
+    {
+        return detail::pow_sliding_window(U{1},
+                                          U{x % m},
+                                          y,
+                                          [&m](const U& a, const U& b) -> U
+                                          {
+                                              return a * b % m;
+                                          },
+                                          [&m](const U& a) -> U
+                                          {
+                                              return sqr(a) % m;
+                                          });
+    }
+
 }
 
 
@@ -2,57 +2,174 @@
 #define XINT_STORAGE_HPP
 
 #include <memory>
+#include <memory_resource>
 #include <utility>
 
+#include "allocator.hpp"
+
 
 #ifndef XINT_MAX_LOCAL_BYTES
 #define XINT_MAX_LOCAL_BYTES 256
 #endif
 
 
+// allocator template for heap-backed uints, e.g. std::allocator or std::pmr::polymorphic_allocator
+#ifndef XINT_HEAP_ALLOCATOR
+#define XINT_HEAP_ALLOCATOR ::xint::pool_allocator
+#endif
+
+
 namespace xint {
 
 
-    template<typename T>
+    /*
+     * Storage on the heap, for large uints.
+     *
+     * The buffer comes from `Alloc` (by default, XINT_HEAP_ALLOCATOR<T>). Stateful
+     * allocators, like std::pmr::polymorphic_allocator, are supported: buffers are only
+     * exchanged between objects with equal allocators, otherwise the data is copied.
+     *
+     * Moving steals the buffer and points the source to a shared read-only zero buffer,
+     * so it reads as zero without allocating; a new buffer is only allocated when it's
+     * written to, or assigned to. Move assignment swaps the buffers.
+     */
+    template<typename T,
+             typename Alloc = XINT_HEAP_ALLOCATOR<T>>
     struct heap_storage {
 
         using data_type = T;
+        using allocator_type = std::allocator_traits<Alloc>::template rebind_alloc<T>;
+
+    private:
+
+        using traits = std::allocator_traits<allocator_type>;
+
+    public:
+
+        [[no_unique_address]]
+        allocator_type alloc;
+
+        data_type* ptr;
+
 
-        heap_storage() = default;
+        heap_storage() :
+            ptr{create()}
+        {}
 
-        heap_storage(const heap_storage& other)
+        heap_storage(const heap_storage& other) :
+            alloc{traits::select_on_container_copy_construction(other.alloc)},
+            ptr{create(*other.ptr)}
+        {}
+
+        heap_storage(heap_storage&& other)
+            noexcept :
+            alloc{other.alloc},
+            ptr{std::exchange(other.ptr, zero())}
+        {}
+
+        ~heap_storage()
         {
-            *ptr = *other.ptr;
+            if (ptr != zero())
+                destroy(ptr);
         }
 
         heap_storage&
         operator =(const heap_storage& other)
-            noexcept
         {
-            *ptr = *other.ptr;
+            if (ptr != zero())
+                *ptr = *other.ptr;
+            else
+                ptr = create(*other.ptr);
+            return *this;
+        }
+
+        heap_storage&
+        operator =(heap_storage&& other)
+            noexcept(traits::is_always_equal::value)
+        {
+            if (shares_buffers(other))
+                std::swap(ptr, other.ptr);
+            else
+                *this = other;
             return *this;
         }
 
 
         constexpr const data_type& operator  *() const noexcept { return *ptr; }
-        constexpr       data_type& operator  *()       noexcept { return *ptr; }
 
-        // constexpr const data_type* operator ->() const noexcept { return ptr->get(); }
-        // constexpr       data_type* operator ->()       noexcept { return ptr->get(); }
+        // a moved-from object gets its own buffer back here
+        constexpr
+        data_type&
+        operator  *()
+        {
+            if (ptr == zero())
+                ptr = create();
+            return *ptr;
+        }
+
+
+        bool
+        shares_buffers(const heap_storage& other)
+            const noexcept
+        {
+            if constexpr (traits::is_always_equal::value)
+                return true;
+            else
+                return alloc == other.alloc;
+        }
+
+    private:
+
+        // what moved-from objects point to; never written to
+        static inline const data_type zero_data{};
+
+        static
+        data_type*
+        zero()
+            noexcept
+        {
+            return const_cast<data_type*>(&zero_data);
+        }
+
+
+        template<typename... Args>
+        data_type*
+        create(Args&&... args)
+        {
+            data_type* p = traits::allocate(alloc, 1);
+            try {
+                traits::construct(alloc, p, std::forward<Args>(args)...);
+            }
+            catch (...) {
+                traits::deallocate(alloc, p, 1);
+                throw;
+            }
+            return p;
+        }
+
+        void
+        destroy(data_type* p)
+            noexcept
+        {
+            traits::destroy(alloc, p);
+            traits::deallocate(alloc, p, 1);
+        }
 
-        std::unique_ptr<data_type> ptr = std::make_unique<data_type>();
     };
 
 
-    template<typename T>
-    constexpr
+    template<typename T,
+             typename Alloc>
     void
-    swap(heap_storage<T>& a,
-         heap_storage<T>& b)
-        noexcept
+    swap(heap_storage<T, Alloc>& a,
+         heap_storage<T, Alloc>& b)
+        noexcept(std::allocator_traits<Alloc>::is_always_equal::value)
     {
         using std::swap;
-        swap(a.ptr, b.ptr);
+        if (a.shares_buffers(b))
+            swap(a.ptr, b.ptr);
+        else
+            swap(*a, *b);
     }
 
 
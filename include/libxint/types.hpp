@@ -34,6 +34,21 @@ namespace xint {
     using wide_limb_type        = std::uint64_t;
     using signed_wide_limb_type = std::int64_t;
 
+#elif XINT_LIMB_SIZE == 64
+
+#ifndef __SIZEOF_INT128__
+#error "XINT_LIMB_SIZE=64 requires a compiler with __int128 support"
+#endif
+
+    using limb_type             = std::uint64_t;
+    // note: __extension__ silences -Wpedantic about the non-standard type
+    __extension__ typedef unsigned __int128 wide_limb_type;
+    __extension__ typedef __int128          signed_wide_limb_type;
+
+#else
+
+#error "XINT_LIMB_SIZE must be 8, 16, 32 or 64"
+
 #endif
 
     static_assert(sizeof(wide_limb_type) > sizeof(limb_type));
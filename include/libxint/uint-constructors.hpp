@@ -2,14 +2,12 @@
 #define XINT_UINT_CONSTRUCTORS_HPP
 
 #include <algorithm>
-#include <cassert>
 #include <limits>
-#include <ranges>
 #include <stdexcept>
 #include <string>
 
 #include "eval-assignment.hpp"
-#include "eval-multiplication.hpp"
+#include "eval-radix.hpp"
 #include "uint.hpp"
 
 
@@ -18,6 +16,7 @@ namespace xint {
 
     template<unsigned Bits, bool Safe>
     template<unsigned Bits2, bool Safe2>
+    constexpr
     uint<Bits, Safe>::uint(const uint<Bits2, Safe2>& other)
         noexcept(is_local && (Bits >= Bits2 || !(Safe || Safe2)))
     {
@@ -30,6 +29,7 @@ namespace xint {
 
     template<unsigned Bits, bool Safe>
     template<std::integral I>
+    constexpr
     uint<Bits, Safe>::uint(I sval)
         noexcept(is_local
                  && (!Safe
@@ -51,7 +51,7 @@ namespace xint {
                     break;
             }
             *out++ = uval;
-            if (limb_bits < U_bits)
+            if constexpr (limb_bits < U_bits)
                 uval >>= limb_bits;
             else // guaranteed to have consumed the whole input
                 break;
@@ -64,15 +64,13 @@ namespace xint {
     uint<Bits, Safe>::uint(const std::string& arg,
                            unsigned base)
     {
-        assert(base <= std::numeric_limits<limb_type>::max());
-
         if (arg.empty())
             throw std::invalid_argument{"argument string is empty"};
 
-        std::ranges::fill(limbs(), 0);
-
-        if (arg == "0")
+        if (arg == "0") {
+            std::ranges::fill(limbs(), 0);
             return;
+        }
 
         auto [dbase, skip] = utils::detect_base(arg);
 
@@ -84,30 +82,18 @@ namespace xint {
             base = dbase;
         if (!base)
             base = 10;
-
-        uint multiplier = 1u;
-        bool too_large = false;
-        for (char c : arg | std::views::drop(skip) | std::views::reverse) {
-            uint x;
-
-            // allow separators
-            // if (c == '\'')
-            //     continue;
-
-            if (too_large && c != '0')
-                throw std::overflow_error{"too_large && c != '0'"};
-
-            limb_type d = static_cast<limb_type>(std::stoul(std::string{c}, nullptr, base));
-            if (eval_mul_limb(x.limbs(),
-                              multiplier.limbs(),
-                              d))
-                throw std::overflow_error{"overflow in eval_mul_limb()"};
-
-            if (eval_add_inplace(limbs(), x.limbs()))
-                throw std::overflow_error{"overflow in eval_add_inplace()"};
-
-            if (eval_mul_inplace_limb(multiplier.limbs(), base))
-                too_large = true;
+        if (base < 2 || base > 36)
+            throw std::invalid_argument{"base must be in [2, 36]"};
+
+        const char* first = arg.data() + skip;
+        const char* last = arg.data() + arg.size();
+        switch (eval_from_chars(limbs(), first, last, base)) {
+            case parse_status::invalid_digit:
+                throw std::invalid_argument{"invalid digit in argument string"};
+            case parse_status::overflow:
+                throw std::overflow_error{"argument string is too large"};
+            case parse_status::success:
+                break;
         }
     }
 
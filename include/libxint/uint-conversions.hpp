@@ -16,6 +16,7 @@ namespace xint {
 
     template<unsigned Bits, bool Safe>
     template<unsigned DestBits>
+    constexpr
     utils::uint_t<DestBits>
     uint<Bits, Safe>::to_uint()
         const noexcept(!Safe || DestBits >= Bits)
@@ -44,6 +45,7 @@ namespace xint {
 
     template<unsigned Bits, bool Safe>
     template<std::unsigned_integral U>
+    constexpr
     uint<Bits, Safe>::operator U()
         const noexcept(noexcept(to_uint<std::numeric_limits<U>::digits>()))
     {
@@ -52,6 +54,7 @@ namespace xint {
 
 
     template<unsigned Bits, bool Safe>
+    constexpr
     uint<Bits, Safe>::operator bool()
         const noexcept
     {
@@ -2,14 +2,20 @@
 #define XINT_UINT_SERIALIZATION_HPP
 
 #include <algorithm>
+#include <bit>
 #include <cctype>
+#include <cstddef> // std::byte, std::size_t
+#include <cstring> // memcpy()
 #include <ranges>
+#include <span>
 #include <stdexcept>
 #include <string>
 
 #include "eval-bits.hpp"
 #include "eval-division.hpp"
+#include "eval-radix.hpp"
 #include "uint.hpp"
+#include "utils.hpp"
 
 
 namespace xint {
@@ -40,21 +46,7 @@ namespace xint {
     uint<Bits, Safe>::to_dec()
         const
     {
-        if (utils::is_zero(limbs()))
-            return "0";
-
-        static const char digits[] = "0123456789";
-        std::string result;
-        uint n = *this;
-        uint m;
-        while (n) {
-            limb_type d;
-            eval_div_limb(m.limbs(), d, n.limbs(), 10);
-            result += digits[d];
-            swap(m, n);
-        }
-        std::ranges::reverse(result);
-        return result;
+        return to_string(10);
     }
 
 
@@ -121,41 +113,130 @@ namespace xint {
         if (utils::is_zero(limbs()))
             return "0";
 
-        static const unsigned char digits[36 + 1] =
-            "0123456789"
-            "abcdefghij"
-            "klmnopqrst"
-            "uvwxyz";
-
-        std::string result;
+        // the digits are written backwards, from the end of the buffer
+        std::string result(max_digits(Bits, base), '\0');
         uint n = *this;
-        uint m;
-        while (n) {
-            limb_type d;
-            eval_div_limb(m.limbs(), d, n.limbs(), base);
-            auto c = digits[d];
-            result += upper ? char(std::toupper(c)) : c;
-            swap(m, n);
-        }
-        std::ranges::reverse(result);
+        char* last = result.data() + result.size();
+        char* first = eval_to_chars(last, n.limbs(), base, upper);
+        result.erase(0, first - result.data());
         return result;
     }
 
 
+    namespace detail {
+
+        // a contiguous range of bytes, that can be copied to with memcpy()
+        template<typename R>
+        concept contiguous_bytes = std::ranges::contiguous_range<R>
+            && std::ranges::sized_range<R>
+            && sizeof(std::ranges::range_value_t<R>) == 1;
+
+
+        /*
+         * The bytes of the limbs are copied as they are when they already have the
+         * right order, and swapped one limb at a time otherwise.
+         */
+
+        inline
+        void
+        store_little_endian(unsigned char* dst,
+                            std::span<const limb_type> src)
+            noexcept
+        {
+            if constexpr (std::endian::native == std::endian::little)
+                std::memcpy(dst, src.data(), src.size_bytes());
+            else
+                for (limb_type x : src) {
+                    x = utils::byteswap(x);
+                    std::memcpy(dst, &x, sizeof x);
+                    dst += sizeof x;
+                }
+        }
+
+
+        inline
+        void
+        store_big_endian(unsigned char* dst,
+                         std::span<const limb_type> src)
+            noexcept
+        {
+            for (std::size_t i = src.size(); i-- > 0;) {
+                limb_type x = src[i];
+                if constexpr (std::endian::native == std::endian::little)
+                    x = utils::byteswap(x);
+                std::memcpy(dst, &x, sizeof x);
+                dst += sizeof x;
+            }
+        }
+
+
+        inline
+        void
+        load_little_endian(std::span<limb_type> dst,
+                           const unsigned char* src)
+            noexcept
+        {
+            if constexpr (std::endian::native == std::endian::little)
+                std::memcpy(dst.data(), src, dst.size_bytes());
+            else
+                for (limb_type& x : dst) {
+                    std::memcpy(&x, src, sizeof x);
+                    x = utils::byteswap(x);
+                    src += sizeof x;
+                }
+        }
+
+
+        inline
+        void
+        load_big_endian(std::span<limb_type> dst,
+                        const unsigned char* src)
+            noexcept
+        {
+            for (std::size_t i = dst.size(); i-- > 0;) {
+                limb_type x;
+                std::memcpy(&x, src, sizeof x);
+                if constexpr (std::endian::native == std::endian::little)
+                    x = utils::byteswap(x);
+                dst[i] = x;
+                src += sizeof x;
+            }
+        }
+
+
+        inline
+        void
+        check_buffer_size(std::size_t size,
+                          std::size_t needed)
+        {
+            if (size < needed)
+                throw std::out_of_range{"buffer is not large enough"};
+        }
+
+    } // namespace detail
+
+
     template<unsigned Bits, bool Safe>
     template<std::ranges::output_range<unsigned char> R>
     std::ranges::iterator_t<R>
     uint<Bits, Safe>::to_little_endian(R&& buffer)
         const
     {
-        auto out = begin(buffer);
-        for (limb_type x : limbs())
-            for (unsigned i = 0; i < sizeof(limb_type); ++i) {
-                if (out == end(buffer))
-                    throw std::out_of_range{"buffer is not large enough"};
-                *out++ = x >> (i * 8);
-            }
-        return out;
+        if constexpr (detail::contiguous_bytes<R>) {
+            detail::check_buffer_size(std::ranges::size(buffer), sizeof(array_type));
+            auto* dst = reinterpret_cast<unsigned char*>(std::ranges::data(buffer));
+            detail::store_little_endian(dst, limbs());
+            return std::ranges::begin(buffer) + sizeof(array_type);
+        } else {
+            auto out = begin(buffer);
+            for (limb_type x : limbs())
+                for (unsigned i = 0; i < sizeof(limb_type); ++i) {
+                    if (out == end(buffer))
+                        throw std::out_of_range{"buffer is not large enough"};
+                    *out++ = x >> (i * 8);
+                }
+            return out;
+        }
     }
 
 
@@ -165,17 +246,124 @@ namespace xint {
     uint<Bits, Safe>::to_big_endian(R&& buffer)
         const
     {
-        auto out = begin(buffer);
-        for (limb_type x : limbs() | std::views::reverse)
-            for (unsigned i = 0; i < sizeof(limb_type); ++i) {
-                if (out == end(buffer))
-                    throw std::out_of_range{"buffer is not large enough"};
-                *out++ = x >> ((sizeof(limb_type) - i - 1) * 8);
+        if constexpr (detail::contiguous_bytes<R>) {
+            detail::check_buffer_size(std::ranges::size(buffer), sizeof(array_type));
+            auto* dst = reinterpret_cast<unsigned char*>(std::ranges::data(buffer));
+            detail::store_big_endian(dst, limbs());
+            return std::ranges::begin(buffer) + sizeof(array_type);
+        } else {
+            auto out = begin(buffer);
+            for (limb_type x : limbs() | std::views::reverse)
+                for (unsigned i = 0; i < sizeof(limb_type); ++i) {
+                    if (out == end(buffer))
+                        throw std::out_of_range{"buffer is not large enough"};
+                    *out++ = x >> ((sizeof(limb_type) - i - 1) * 8);
+                }
+            return out;
+        }
+    }
+
+
+    template<unsigned Bits, bool Safe>
+    std::span<std::byte>::iterator
+    uint<Bits, Safe>::to_little_endian(std::span<std::byte> buffer)
+        const
+    {
+        detail::check_buffer_size(buffer.size(), sizeof(array_type));
+        detail::store_little_endian(reinterpret_cast<unsigned char*>(buffer.data()), limbs());
+        return buffer.begin() + sizeof(array_type);
+    }
+
+
+    template<unsigned Bits, bool Safe>
+    std::span<std::byte>::iterator
+    uint<Bits, Safe>::to_big_endian(std::span<std::byte> buffer)
+        const
+    {
+        detail::check_buffer_size(buffer.size(), sizeof(array_type));
+        detail::store_big_endian(reinterpret_cast<unsigned char*>(buffer.data()), limbs());
+        return buffer.begin() + sizeof(array_type);
+    }
+
+
+    template<unsigned Bits, bool Safe>
+    template<std::ranges::input_range R>
+    requires std::convertible_to<std::ranges::range_reference_t<R>, unsigned char>
+    uint<Bits, Safe>
+    uint<Bits, Safe>::from_little_endian(R&& buffer)
+    {
+        uint result;
+        if constexpr (detail::contiguous_bytes<R>) {
+            detail::check_buffer_size(std::ranges::size(buffer), sizeof(array_type));
+            auto* src = reinterpret_cast<const unsigned char*>(std::ranges::data(buffer));
+            detail::load_little_endian(result.limbs(), src);
+        } else {
+            auto in = std::ranges::begin(buffer);
+            const auto last = std::ranges::end(buffer);
+            for (limb_type& x : result.limbs()) {
+                x = 0;
+                for (unsigned i = 0; i < sizeof(limb_type); ++i, ++in) {
+                    if (in == last)
+                        throw std::out_of_range{"buffer is not large enough"};
+                    x |= static_cast<limb_type>(limb_type{static_cast<unsigned char>(*in)}
+                                                << (i * 8));
+                }
+            }
+        }
+        return result;
+    }
+
+
+    template<unsigned Bits, bool Safe>
+    template<std::ranges::input_range R>
+    requires std::convertible_to<std::ranges::range_reference_t<R>, unsigned char>
+    uint<Bits, Safe>
+    uint<Bits, Safe>::from_big_endian(R&& buffer)
+    {
+        uint result;
+        if constexpr (detail::contiguous_bytes<R>) {
+            detail::check_buffer_size(std::ranges::size(buffer), sizeof(array_type));
+            auto* src = reinterpret_cast<const unsigned char*>(std::ranges::data(buffer));
+            detail::load_big_endian(result.limbs(), src);
+        } else {
+            auto in = std::ranges::begin(buffer);
+            const auto last = std::ranges::end(buffer);
+            for (limb_type& x : result.limbs() | std::views::reverse) {
+                x = 0;
+                for (unsigned i = 0; i < sizeof(limb_type); ++i, ++in) {
+                    if (in == last)
+                        throw std::out_of_range{"buffer is not large enough"};
+                    x = static_cast<limb_type>(x << 8 | static_cast<unsigned char>(*in));
+                }
             }
-        return out;
+        }
+        return result;
+    }
+
+
+    template<unsigned Bits, bool Safe>
+    uint<Bits, Safe>
+    uint<Bits, Safe>::from_little_endian(std::span<const std::byte> buffer)
+    {
+        detail::check_buffer_size(buffer.size(), sizeof(array_type));
+        uint result;
+        detail::load_little_endian(result.limbs(),
+                                   reinterpret_cast<const unsigned char*>(buffer.data()));
+        return result;
     }
 
 
+    template<unsigned Bits, bool Safe>
+    uint<Bits, Safe>
+    uint<Bits, Safe>::from_big_endian(std::span<const std::byte> buffer)
+    {
+        detail::check_buffer_size(buffer.size(), sizeof(array_type));
+        uint result;
+        detail::load_big_endian(result.limbs(),
+                                reinterpret_cast<const unsigned char*>(buffer.data()));
+        return result;
+    }
+
 }
 
 
@@ -9,10 +9,12 @@
 
 #include <array>
 #include <concepts>
-#include <cstddef> // std::size_t
+#include <cstddef> // std::byte, std::size_t
 #include <limits>
 #include <ranges>
+#include <span>
 #include <string>
+#include <type_traits>
 
 #include "types.hpp"
 #include "utils.hpp"
@@ -48,55 +50,61 @@ namespace xint {
 
         storage_type data;
 
-        constexpr const array_type& limbs() const noexcept { return *data; }
-        constexpr       array_type& limbs()       noexcept { return *data; }
+        // note: the non-const ones allocate a new buffer for a moved-from heap uint
+        constexpr const array_type& limbs() const noexcept           { return *data; }
+        constexpr       array_type& limbs()       noexcept(is_local) { return *data; }
 
-        constexpr const limb_type& limb(std::size_t idx) const noexcept { return limbs()[idx]; }
-        constexpr       limb_type& limb(std::size_t idx)       noexcept { return limbs()[idx]; }
+        constexpr const limb_type& limb(std::size_t i) const noexcept           { return limbs()[i]; }
+        constexpr       limb_type& limb(std::size_t i)       noexcept(is_local) { return limbs()[i]; }
 
 
         // constructors
 
         constexpr uint() noexcept(is_local) = default;
         constexpr uint(const uint&) noexcept(is_local) = default;
+        constexpr uint(uint&&) noexcept = default;
 
         template<unsigned Bits2, bool Safe2>
         explicit(!Safe && Safe2) // must be explicit when lifting up safety
-        uint(const uint<Bits2, Safe2>&)
+        constexpr uint(const uint<Bits2, Safe2>&)
             noexcept(is_local && (Bits >= Bits2 || !(Safe || Safe2)));
 
 
         template<std::integral I>
-        uint(I sval)
+        constexpr uint(I sval)
             noexcept(is_local
                      && (!Safe
                          ||
                          std::numeric_limits<std::make_unsigned_t<I>>::digits <= Bits));
 
-        // note: base must be a valid argument for std::stoul()
+        // note: base is in [2, 36], or 0 to detect it from the prefix (default is 10)
         explicit uint(const std::string& arg, unsigned base = 0);
 
 
         // assignment
 
+        constexpr uint& operator =(const uint&) noexcept(is_local) = default;
+        constexpr uint& operator =(uint&&)
+            noexcept(std::is_nothrow_move_assignable_v<storage_type>) = default;
+
         template<unsigned Bits2, bool Safe2>
         requires(Safe || !Safe2) // can only be used to add safety, not to remove
         uint& operator =(const uint<Bits2, Safe2>& other)
-            noexcept((Bits == Bits2) || (!Safe && !Safe2));
+            noexcept(is_local && ((Bits == Bits2) || (!Safe && !Safe2)));
 
 
         // conversions
 
         template<unsigned DestBits>
-        utils::uint_t<DestBits> to_uint() const noexcept(!Safe || DestBits >= Bits);
+        constexpr utils::uint_t<DestBits> to_uint() const noexcept(!Safe || DestBits >= Bits);
 
         template<std::unsigned_integral U>
-        explicit
+        constexpr explicit
         operator U() const
             noexcept(noexcept(to_uint<std::numeric_limits<U>::digits>()));
 
 
-        explicit
+        constexpr explicit
         operator bool() const noexcept;
 
 
@@ -113,6 +121,7 @@ namespace xint {
         std::string to_oct() const;
         std::string to_string(unsigned base, bool upper = false) const;
 
+        // note: these throw std::out_of_range when the buffer is smaller than the limbs
         template<std::ranges::output_range<unsigned char> R>
         std::ranges::iterator_t<R>
         to_little_endian(R&& buffer) const;
@@ -121,6 +130,27 @@ namespace xint {
         std::ranges::iterator_t<R>
         to_big_endian(R&& buffer) const;
 
+        std::span<std::byte>::iterator
+        to_little_endian(std::span<std::byte> buffer) const;
+
+        std::span<std::byte>::iterator
+        to_big_endian(std::span<std::byte> buffer) const;
+
+        template<std::ranges::input_range R>
+        requires std::convertible_to<std::ranges::range_reference_t<R>, unsigned char>
+        static
+        uint
+        from_little_endian(R&& buffer);
+
+        template<std::ranges::input_range R>
+        requires std::convertible_to<std::ranges::range_reference_t<R>, unsigned char>
+        static
+        uint
+        from_big_endian(R&& buffer);
+
+        static uint from_little_endian(std::span<const std::byte> buffer);
+        static uint from_big_endian(std::span<const std::byte> buffer);
+
     };
 
 
@@ -142,6 +172,8 @@ namespace xint {
 #include "uint-serialization.hpp"
 
 // the rest is implemented here
+#include "charconv.hpp"
+#include "format.hpp"
 #include "limits.hpp"
 #include "literals.hpp"
 #include "operators.hpp"
@@ -2,11 +2,16 @@
 #define XINT_UTILS_HPP
 
 #include <algorithm>
+#include <bit>
+#include <concepts>
+#include <cstddef> // std::size_t
 #include <cstdint>
+#include <limits>
 #include <optional>
 #include <ranges>
 #include <string>
-#include <utility> // pair
+#include <type_traits>
+#include <utility> // pair, index_sequence
 
 
 namespace xint::utils {
@@ -29,6 +34,7 @@ namespace xint::utils {
 
 
     template<limb_range R>
+    constexpr
     bool
     is_zero(const R& r) noexcept
     {
@@ -37,6 +43,7 @@ namespace xint::utils {
 
 
     template<limb_range R>
+    constexpr
     bool
     is_nonzero(const R& r) noexcept
     {
@@ -58,12 +65,76 @@ namespace xint::utils {
 
 
 
+#ifndef XINT_UNROLL_LIMBS
+#define XINT_UNROLL_LIMBS 16
+#endif
+
+    // loops over a fixed number of limbs, up to this many, are unrolled
+    inline constexpr std::size_t unroll_limbs = XINT_UNROLL_LIMBS;
+
+
+    /*
+     * Calls f(i) for each i in [0, N).
+     * When N <= unroll_limbs the calls are unrolled, and i is a std::integral_constant.
+     */
+    template<std::size_t N,
+             typename F>
+    constexpr
+    void
+    for_each_index(F&& f)
+    {
+        if constexpr (N <= unroll_limbs)
+            [&f]<std::size_t... I>(std::index_sequence<I...>)
+            {
+                (f(std::integral_constant<std::size_t, I>{}), ...);
+            }(std::make_index_sequence<N>{});
+        else
+            for (std::size_t i = 0; i < N; ++i)
+                f(i);
+    }
+
+
+    // std::byteswap() is only in C++23
+    template<std::unsigned_integral U>
+    constexpr
+    U
+    byteswap(U x)
+        noexcept
+    {
+#if __cpp_lib_byteswap >= 202110L
+        return std::byteswap(x);
+#else
+        if constexpr (sizeof(U) == 1)
+            return x;
+#if defined(__GNUC__)
+        else if constexpr (sizeof(U) == 2)
+            return __builtin_bswap16(x);
+        else if constexpr (sizeof(U) == 4)
+            return __builtin_bswap32(x);
+        else if constexpr (sizeof(U) == 8)
+            return __builtin_bswap64(x);
+#endif
+        else {
+            U r = 0;
+            for (unsigned i = 0; i < sizeof(U); ++i) {
+                r = static_cast<U>(r << 8 | (x & 0xff));
+                x >>= 8;
+            }
+            return r;
+        }
+#endif
+    }
+
+
     template<unsigned> struct uint_t_helper;
 
     template<> struct uint_t_helper<8>  { using type = std::uint8_t;  };
     template<> struct uint_t_helper<16> { using type = std::uint16_t; };
     template<> struct uint_t_helper<32> { using type = std::uint32_t; };
     template<> struct uint_t_helper<64> { using type = std::uint64_t; };
+#ifdef __SIZEOF_INT128__
+    template<> struct uint_t_helper<128> { __extension__ typedef unsigned __int128 type; };
+#endif
 
     template<unsigned Bits> using uint_t = uint_t_helper<Bits>::type;
 
@@ -190,3 +190,36 @@ TEST_CASE("eval_add")
     }
 
 }
+
+
+TEMPLATE_TEST_CASE_SIG("eval_add_fixed", "[fixed][random]",
+                       ((unsigned Bits), Bits), 8, 16, 32, 128, 136)
+{
+    using U = xint::uint<Bits>;
+
+    for (unsigned i = 0; i < 1000; ++i) {
+        U a;
+        U b;
+        for (auto& x : a.limbs())
+            x = static_cast<xint::limb_type>(utils::rand64());
+        for (auto& x : b.limbs())
+            x = static_cast<xint::limb_type>(utils::rand64());
+
+        U ref;
+        U out;
+        bool overflow = xint::eval_add(ref.limbs(), a.limbs(), b.limbs());
+        CHECK(overflow == xint::eval_add_fixed(out.limbs(), a.limbs(), b.limbs()));
+        CHECK(out == ref);
+
+        // in place
+        CHECK(overflow == xint::eval_add_fixed(a.limbs(), a.limbs(), b.limbs()));
+        CHECK(a == ref);
+    }
+
+    const U ones = ~U{0};
+    U out;
+    CHECK(xint::eval_add_fixed(out.limbs(), ones.limbs(), U{1}.limbs()));
+    CHECK(out == 0);
+    CHECK(!xint::eval_add_fixed(out.limbs(), ones.limbs(), U{0}.limbs()));
+    CHECK(out == ones);
+}
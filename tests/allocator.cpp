@@ -0,0 +1,152 @@
+#include <array>
+#include <cstddef>
+#include <memory_resource>
+#include <thread>
+
+// heap-backed uints in this test use the default memory resource
+#define XINT_HEAP_ALLOCATOR std::pmr::polymorphic_allocator
+
+#include <libxint/uint.hpp>
+
+#include "catch2/catch_amalgamated.hpp"
+
+
+using x4096 = xint::uint<4096>;
+static_assert(!x4096::is_local);
+
+
+struct counting_resource : std::pmr::memory_resource {
+
+    std::size_t allocs = 0;
+    std::size_t frees = 0;
+
+    void*
+    do_allocate(std::size_t bytes,
+                std::size_t align)
+        override
+    {
+        ++allocs;
+        return std::pmr::new_delete_resource()->allocate(bytes, align);
+    }
+
+    void
+    do_deallocate(void* p,
+                  std::size_t bytes,
+                  std::size_t align)
+        override
+    {
+        ++frees;
+        std::pmr::new_delete_resource()->deallocate(p, bytes, align);
+    }
+
+    bool
+    do_is_equal(const std::pmr::memory_resource& other)
+        const noexcept override
+    {
+        return this == &other;
+    }
+
+};
+
+
+TEST_CASE("pool")
+{
+    using block = std::array<xint::limb_type, 128>;
+    xint::pool_allocator<block> alloc;
+
+    block* a = alloc.allocate(1);
+    block* b = alloc.allocate(1);
+    CHECK(a != b);
+    alloc.deallocate(a, 1);
+    alloc.deallocate(b, 1);
+
+    // freed blocks are reused, last in first out
+    CHECK(alloc.allocate(1) == b);
+    CHECK(alloc.allocate(1) == a);
+
+    // blocks can be freed by another thread
+    block* c = nullptr;
+    std::thread{[&c] { c = xint::pool_allocator<block>{}.allocate(1); }}.join();
+    alloc.deallocate(c, 1);
+    CHECK(alloc.allocate(1) == c);
+
+    alloc.deallocate(a, 1);
+    alloc.deallocate(b, 1);
+    alloc.deallocate(c, 1);
+
+    // arrays bypass the pool
+    block* d = alloc.allocate(3);
+    alloc.deallocate(d, 3);
+}
+
+
+TEST_CASE("pmr")
+{
+    counting_resource res1;
+    counting_resource res2;
+
+    auto old = std::pmr::set_default_resource(&res1);
+    {
+        x4096 a = 1;
+        x4096 b = a + 2;
+        CHECK(b == 3);
+        CHECK(res1.allocs == 2);
+
+        std::pmr::set_default_resource(&res2);
+        x4096 c = 5;
+        CHECK(res2.allocs == 1);
+
+        // different resources: the data is copied, buffers stay where they are
+        const auto* buf = a.limbs().data();
+        a = std::move(c);
+        CHECK(a == 5);
+        CHECK(a.limbs().data() == buf);
+
+        // same resource: buffers are swapped
+        x4096 d = 7;
+        const auto* dbuf = d.limbs().data();
+        c = std::move(d);
+        CHECK(c == 7);
+        CHECK(c.limbs().data() == dbuf);
+
+        swap(a, b);
+        CHECK(a == 3);
+        CHECK(b == 5);
+
+        // moved-from objects keep a buffer from their own resource
+        x4096 e = std::move(c);
+        CHECK(e == 7);
+        a = std::move(c);
+        CHECK(a == 0u);
+        swap(b, c);
+        CHECK(b == 0u);
+        CHECK(c == 5);
+    }
+
+    // moves and chained rvalue + and - don't allocate
+    counting_resource res3;
+    std::pmr::set_default_resource(&res3);
+    {
+        x4096 a = 1;
+        x4096 b = 2;
+        x4096 c = 3;
+        x4096 d = std::move(a);
+        x4096 e = a + b + c + d - b;
+        x4096 f = std::move(e) + d;
+        const std::size_t allocs = res3.allocs;
+        CHECK(allocs == 4);
+        CHECK(d == 1);
+        CHECK(f == 5);
+
+        // a moved-from object allocates when it's written to
+        a += f;
+        CHECK(res3.allocs == allocs + 1);
+        CHECK(a == 5);
+    }
+    std::pmr::set_default_resource(old);
+
+    CHECK(res1.allocs == res1.frees);
+    CHECK(res2.allocs == res2.frees);
+    CHECK(res3.allocs == res3.frees);
+}
+
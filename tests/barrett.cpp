@@ -0,0 +1,81 @@
+#include <cstdint>
+#include <stdexcept>
+
+#include <libxint/uint.hpp>
+#include <libxint/barrett.hpp>
+
+#include "catch2/catch_amalgamated.hpp"
+#include "utils/random.hpp"
+
+
+const unsigned max_tries = 10000;
+
+
+TEST_CASE("random64", "[random][64]")
+{
+    using std::uint64_t;
+    using x64 = xint::uint<64>;
+
+    for (unsigned i = 0; i < max_tries; ++i) {
+        const uint64_t m = utils::rand64() >> utils::rand(63);
+        if (!m)
+            continue;
+        xint::barrett<x64> bar{m};
+        for (unsigned j = 0; j < 10; ++j) {
+            const uint64_t x = utils::rand64();
+            auto [q, r] = bar.divmod(x);
+            CHECK(q == x / m);
+            CHECK(r == x % m);
+            CHECK(bar.reduce(x) == x % m);
+        }
+    }
+}
+
+
+TEMPLATE_TEST_CASE_SIG("random", "[random]",
+                       ((unsigned Bits), Bits), 128, 256, 1024)
+{
+    using U = xint::uint<Bits>;
+
+    for (unsigned i = 0; i < 100; ++i) {
+        U m = utils::random_uint<Bits>(utils::rand(1, Bits));
+        if (!m)
+            continue;
+        xint::barrett<U> bar{m};
+        for (unsigned j = 0; j < 10; ++j) {
+            U x = utils::random_uint<Bits>(utils::rand(1, Bits));
+            // values just below a multiple of m stress the correction step
+            if (utils::rand(3) == 0)
+                x = (x / m) * m - 1;
+            auto [q, r] = bar.divmod(x);
+            auto [q_ref, r_ref] = div(x, m);
+            CHECK(q == q_ref);
+            CHECK(r == r_ref);
+        }
+    }
+}
+
+
+TEST_CASE("special", "[64]")
+{
+    using x64 = xint::uint<64>;
+
+    CHECK_THROWS_AS(xint::barrett<x64>{x64{0}}, std::domain_error);
+
+    // even modulus, power of two, and 1
+    xint::barrett<x64> even{x64{1000}};
+    CHECK(even.reduce(x64{123456789}) == 789);
+
+    xint::barrett<x64> pow2{x64{256}};
+    CHECK(pow2.reduce(x64{0x12345}) == 0x45);
+
+    xint::barrett<x64> one{x64{1}};
+    auto [q, r] = one.divmod(~x64{0});
+    CHECK(q == ~x64{0});
+    CHECK(r == 0);
+
+    // largest modulus
+    xint::barrett<x64> big{~x64{0}};
+    CHECK(big.reduce(~x64{0}) == 0);
+    CHECK(big.reduce(~x64{0} - 1) == ~x64{0} - 1);
+}
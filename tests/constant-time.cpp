@@ -0,0 +1,98 @@
+#include <stdexcept>
+
+#include <libxint/uint.hpp>
+#include <libxint/constant-time.hpp>
+
+#include "catch2/catch_amalgamated.hpp"
+#include "utils/random.hpp"
+
+
+TEMPLATE_TEST_CASE_SIG("basic", "[basic]",
+                       ((unsigned Bits), Bits), 64, 256, 1024)
+{
+    using U = xint::uint<Bits>;
+    using S = xint::uint<Bits, true>;
+
+    for (unsigned i = 0; i < 1000; ++i) {
+        const U a = utils::random_uint<Bits>(utils::rand(1, Bits));
+        const U b = utils::random_uint<Bits>(utils::rand(1, Bits));
+
+        CHECK(xint::ct::add(a, b) == a + b);
+        CHECK(xint::ct::sub(a, b) == a - b);
+        CHECK(xint::ct::less(a, b) == (a < b));
+        CHECK(xint::ct::less(b, a) == (b < a));
+        CHECK(xint::ct::equal(a, b) == (a == b));
+        CHECK(xint::ct::equal(a, a));
+        CHECK_FALSE(xint::ct::less(a, a));
+        CHECK(xint::ct::select(true, a, b) == a);
+        CHECK(xint::ct::select(false, a, b) == b);
+
+        U x = a;
+        U y = b;
+        xint::ct::cswap(false, x, y);
+        CHECK(x == a);
+        CHECK(y == b);
+        xint::ct::cswap(true, x, y);
+        CHECK(x == b);
+        CHECK(y == a);
+
+        // never throws, even on safe types
+        const S sa = a;
+        const S sb = b;
+        CHECK(xint::ct::add(sa, sb) == S{a + b});
+        CHECK(xint::ct::sub(sa, sb) == S{a - b});
+    }
+}
+
+
+TEMPLATE_TEST_CASE_SIG("division", "[division]",
+                       ((unsigned Bits), Bits), 128, 256, 1024)
+{
+    using U = xint::uint<Bits>;
+    using H = xint::uint<Bits / 2>;
+
+    for (unsigned i = 0; i < 200; ++i) {
+        const U a = utils::random_uint<Bits>(utils::rand(1, Bits));
+        U b = utils::random_uint<Bits>(utils::rand(1, Bits));
+        if (!b)
+            b = 1;
+
+        auto [q, r] = xint::ct::div(a, b);
+        CHECK(q == a / b);
+        CHECK(r == a % b);
+
+        // narrower divisor
+        H hb = utils::random_uint<Bits / 2>(utils::rand(1, Bits / 2));
+        if (!hb)
+            hb = 1;
+        auto [hq, hr] = xint::ct::div(a, hb);
+        auto [eq, er] = div(a, U{hb});
+        CHECK(hq == eq);
+        CHECK(U{hr} == er);
+    }
+
+    CHECK_THROWS_AS(xint::ct::div(U{1}, U{0}), std::domain_error);
+}
+
+
+TEMPLATE_TEST_CASE_SIG("powm", "[powm]",
+                       ((unsigned Bits), Bits), 64, 256, 1024)
+{
+    using U = xint::uint<Bits>;
+    using W = xint::uint<2 * Bits>;
+
+    for (unsigned i = 0; i < 50; ++i) {
+        U m = utils::random_uint<Bits>(utils::rand(2, Bits));
+        m.limb(0) |= 1;
+        const U x = utils::random_uint<Bits>();
+        const U y = utils::random_uint<Bits>(utils::rand(1, Bits));
+
+        // the regular powm() needs twice the bits to not overflow
+        CHECK(xint::ct::powm(x, y, m) == U{powm(W{x}, W{y}, W{m})});
+    }
+
+    CHECK(xint::ct::powm(U{5}, U{0}, U{7}) == 1);
+    CHECK(xint::ct::powm(U{5}, U{3}, U{1}) == 0);
+    CHECK(xint::ct::powm(U{3}, U{200}, U{1000000007}) == powm(U{3}, U{200}, U{1000000007}));
+    CHECK_THROWS_AS(xint::ct::powm(U{3}, U{2}, U{10}), std::domain_error);
+}
@@ -1,4 +1,6 @@
 #include <algorithm>
+#include <limits>
+#include <utility> // as_const()
 #include <vector>
 
 #include <libxint/uint.hpp>
@@ -130,6 +132,125 @@ TEST_CASE("string")
         CHECK_THROWS_AS(x64("0x1ffffffffffffffff"), std::overflow_error);
         // must throw with invalid char
         CHECK_THROWS_AS(x64("123:"), std::invalid_argument);
+        CHECK_THROWS_AS(x64("0x12g"), std::invalid_argument);
+        CHECK_THROWS_AS(x64("0o178"), std::invalid_argument);
+        CHECK_THROWS_AS(x64("12a", 10), std::invalid_argument);
+        CHECK_THROWS_AS(x64("1", 37), std::invalid_argument);
     }
 
 }
+
+
+TEST_CASE("string limits")
+{
+    using x64 = xint::uint<64>;
+    using x8192 = xint::uint<8192>;
+    using lim = std::numeric_limits<uint64_t>;
+
+    // the largest value in each base, and one more
+    CHECK(x64{"18446744073709551615"} == lim::max());
+    CHECK_THROWS_AS(x64{"18446744073709551616"}, std::overflow_error);
+    CHECK(x64{"0xffffffffffffffff"} == lim::max());
+    CHECK(x64{"FFFFFFFFFFFFFFFF", 16} == lim::max());
+    CHECK_THROWS_AS(x64{"0x10000000000000000"}, std::overflow_error);
+    CHECK(x64{"0o1777777777777777777777"} == lim::max());
+    CHECK_THROWS_AS(x64{"0o2000000000000000000000"}, std::overflow_error);
+    CHECK(x64{"3w5e11264sgsf", 36} == lim::max());
+    CHECK_THROWS_AS((x64{"3w5e11264sgsg", 36}), std::overflow_error);
+
+    // leading zeros don't count
+    CHECK(x64{"0o" + string(200, '0') + "123"} == 0123u);
+    CHECK(x64{"0x" + string(200, '0') + "abc"} == 0xabcu);
+
+    // long enough to be split
+    string dec = "9";
+    for (unsigned i = 0; i < 2400; ++i)
+        dec += char('0' + (i * 7 + i / 13) % 10);
+    x8192 a{dec};
+    CHECK(a.to_dec() == dec);
+    CHECK(x8192{dec.substr(0, 1500)}.to_dec() == dec.substr(0, 1500));
+    CHECK_THROWS_AS(x8192{dec + dec}, std::overflow_error);
+}
+
+
+TEST_CASE("literals")
+{
+    using namespace xint::literals;
+
+    // evaluated at compile time
+    static constexpr auto p = 0xffffffffffffffffffffffffffffffff_uint;
+    static_assert(p.num_bits == 128);
+    static_assert(p == ~decltype(p){0});
+    static_assert(0_uint == 0);
+    static_assert(0b1010_uint == 10);
+    static_assert(017_uint == 15);
+    static_assert(0XfF_uint == 255);
+    static_assert(1'000'000_uint == 1000000);
+    static_assert(xint::uint<64>{p} == ~uint64_t{0});
+
+    CHECK(p.to_hex() == "ffffffffffffffffffffffffffffffff");
+    CHECK(340282366920938463463374607431768211455_uint == p);
+
+    // too large for local storage, only the limbs are computed at compile time
+    auto big = 0x8000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000001_uint;
+    static_assert(!decltype(big)::is_local);
+    CHECK(bit_width(big) == 4 * big.to_hex().size());
+    CHECK(popcount(big) == 2);
+    CHECK(big.limb(0) == 1);
+}
+
+
+TEST_CASE("move")
+{
+    using x4096 = xint::uint<4096>;
+    static_assert(!x4096::is_local);
+    static_assert(std::is_nothrow_move_constructible_v<x4096>);
+    static_assert(std::is_nothrow_move_assignable_v<x4096>);
+
+    x4096 a = 12345;
+    const auto* buf = a.limbs().data();
+
+    // moving steals the buffer
+    x4096 b = std::move(a);
+    CHECK(b == 12345);
+    CHECK(b.limbs().data() == buf);
+
+    // moved-from objects read as zero, and get a new buffer when written to
+    CHECK(a == 0u);
+    CHECK(std::as_const(a).limbs().data() != buf);
+    x4096 a2 = a;
+    CHECK(a2 == 0u);
+    a += b;
+    CHECK(a == 12345);
+    a = b;
+    CHECK(a == 12345);
+    CHECK(a.limbs().data() != buf);
+
+    x4096 c = std::move(a);
+    a = x4096{7};
+    CHECK(a == 7);
+
+    x4096 d = std::move(c);
+    c = xint::uint<64>{9};
+    CHECK(c == 9);
+
+    // move assignment swaps the buffers
+    b = std::move(a);
+    CHECK(b == 7);
+    CHECK(a.limbs().data() == buf);
+
+    // a temporary on the left side of + and - is reused
+    x4096 e = b * 3;
+    const auto* ebuf = e.limbs().data();
+    x4096 f = std::move(e) + d;
+    CHECK(f == 21 + 12345);
+    CHECK(f.limbs().data() == ebuf);
+    x4096 g = std::move(f) - b;
+    CHECK(g == 21 + 12345 - 7);
+    CHECK(g.limbs().data() == ebuf);
+    CHECK(b * 2 + b + b - b == 21);
+
+    using s4096 = xint::uint<4096, true>;
+    CHECK_THROWS_AS(s4096{1} - s4096{2}, std::overflow_error);
+    CHECK_THROWS_AS(~s4096{0} + s4096{1}, std::overflow_error);
+}
@@ -89,3 +89,27 @@ TEST_CASE("special", "[64]")
         CHECK(xd == 0);
     }
 }
+
+
+TEMPLATE_TEST_CASE_SIG("random multi-limb", "[random]",
+                       ((unsigned Bits), Bits), 128, 1024, 4096)
+{
+    using U = xint::uint<Bits>;
+    using W = xint::uint<2 * Bits>;
+
+    for (unsigned i = 0; i < 1000; ++i) {
+        U a = utils::random_uint<Bits>(utils::rand(1, Bits));
+        U b = utils::random_uint<Bits>(utils::rand(1, Bits));
+        // sometimes use all ones, to stress the quotient estimation
+        if (utils::rand(3) == 0)
+            a = ~U{0} >> utils::rand(Bits - 1);
+        if (utils::rand(3) == 0)
+            b = ~U{0} >> utils::rand(Bits - 1);
+        if (!b)
+            continue;
+
+        auto [q, r] = div(a, b);
+        CHECK(r < b);
+        CHECK(W{q} * W{b} + W{r} == W{a});
+    }
+}
@@ -0,0 +1,117 @@
+#include <stdexcept>
+
+#include <libxint/uint.hpp>
+#include <libxint/expression.hpp>
+
+#include "catch2/catch_amalgamated.hpp"
+#include "utils/random.hpp"
+
+
+using xint::lazy;
+
+
+TEMPLATE_TEST_CASE_SIG("same as eager", "[eager]",
+                       ((unsigned Bits), Bits), 64, 256, 4096)
+{
+    using U = xint::uint<Bits>;
+
+    for (unsigned i = 0; i < 200; ++i) {
+        const U a = utils::random_uint<Bits>(utils::rand(1, Bits));
+        const U b = utils::random_uint<Bits>(utils::rand(1, Bits));
+        const U c = utils::random_uint<Bits>(utils::rand(1, Bits));
+        U m = utils::random_uint<Bits>(utils::rand(1, Bits));
+        if (!m)
+            m = 1;
+        const unsigned s = utils::rand(0, Bits + 10);
+
+        // fused
+        CHECK(U{lazy(a) * b + c} == a * b + c);
+        CHECK(U{c + lazy(a) * b} == c + a * b);
+        CHECK(U{(lazy(a) >> s) & m} == ((a >> s) & m));
+        CHECK(U{m & (lazy(a) << s)} == (m & (a << s)));
+        for (unsigned k = 0; k < 3; ++k) {
+            const unsigned sl = k * xint::limb_bits;
+            CHECK(U{(lazy(a) >> sl) & m} == ((a >> sl) & m));
+            CHECK(U{(lazy(a) << sl) & m} == ((a << sl) & m));
+        }
+
+        // in place
+        CHECK(U{lazy(a) + b + c} == a + b + c);
+        CHECK(U{lazy(a) - b - c} == a - b - c);
+        CHECK(U{(lazy(a) & b) | (lazy(c) ^ m)} == ((a & b) | (c ^ m)));
+
+        // generic
+        CHECK(U{lazy(a) * b * c} == a * b * c);
+        CHECK(U{lazy(a) / m + 1} == a / m + 1);
+        CHECK(U{lazy(a) % m} == a % m);
+        CHECK(U{(lazy(a) + b) * (lazy(c) - m)} == (a + b) * (c - m));
+        CHECK(U{lazy(a) << s >> 3} == (a << s >> 3));
+
+        U r = a;
+        r = lazy(r) + b;
+        CHECK(r == a + b);
+        CHECK(eval(lazy(a) + b) == a + b);
+    }
+}
+
+
+TEMPLATE_TEST_CASE_SIG("mulmod", "[mulmod]",
+                       ((unsigned Bits), Bits), 64, 256, 4096)
+{
+    using U = xint::uint<Bits>;
+    using W = xint::uint<2 * Bits>;
+
+    for (unsigned i = 0; i < 100; ++i) {
+        U m = utils::random_uint<Bits>(utils::rand(1, Bits));
+        if (!m)
+            m = 1;
+        const U a = utils::random_uint<Bits>() % m;
+        const U b = utils::random_uint<Bits>() % m;
+
+        // the product is never truncated
+        const U r = (lazy(a) * b) % m;
+        CHECK(r == U{W{a} * W{b} % W{m}});
+    }
+}
+
+
+TEST_CASE("mixed")
+{
+    using x64 = xint::uint<64>;
+    using x128 = xint::uint<128>;
+
+    const x64 a = 0xffffffffffffffffu;
+    const x128 b = 3;
+
+    // same result types as the regular operators
+    static_assert(std::same_as<decltype(eval(lazy(a) + b)), x128>);
+    static_assert(std::same_as<decltype(eval(lazy(a) * 2u + 1u)), x64>);
+    static_assert(std::same_as<decltype(eval(lazy(b) / a)), x128>);
+
+    CHECK(eval(lazy(a) + b) == a + b);
+    CHECK(eval(lazy(a) * b + a) == a * b + a);
+    CHECK(eval(lazy(a) * 2u + 1u) == a * 2u + 1u);
+
+    // temporaries are moved into the expression
+    CHECK(eval(lazy(a + 1) + 1) == 1);
+}
+
+
+TEST_CASE("safe")
+{
+    using s64 = xint::uint<64, true>;
+    const s64 a = 0xffffffff;
+    const s64 b = 0x100000001;
+    const s64 c = 0xffffffffffffffff;
+
+    CHECK(s64{lazy(a) * a + b} == a * a + b);
+    CHECK_THROWS_AS(s64{lazy(a) * b + 1}, std::overflow_error);
+    CHECK_THROWS_AS(s64{lazy(b) * b}, std::overflow_error);
+    CHECK_THROWS_AS(s64{lazy(c) + 1}, std::overflow_error);
+    CHECK_THROWS_AS(s64{lazy(a) - b}, std::overflow_error);
+    CHECK_THROWS_AS(s64{(lazy(a) >> 4) & c}, std::overflow_error);
+    CHECK_THROWS_AS(s64{lazy(a) % 0}, std::domain_error);
+
+    // the fused modulo doesn't overflow
+    CHECK(s64{(lazy(c) * c) % 10} == 5);
+}
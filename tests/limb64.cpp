@@ -0,0 +1,266 @@
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#undef XINT_LIMB_SIZE
+#define XINT_LIMB_SIZE 64
+// also test the vector backends, when the CPU has them
+#ifndef XINT_USE_SIMD
+#define XINT_USE_SIMD 1
+#endif
+#include <libxint/uint.hpp>
+#include <libxint/montgomery.hpp>
+
+#include "catch2/catch_amalgamated.hpp"
+#include "utils/random.hpp"
+
+
+const unsigned max_tries = 100000;
+
+
+using u128 = unsigned __int128;
+
+using x128 = xint::uint<128>;
+
+
+static_assert(sizeof(xint::limb_type) == 8);
+static_assert(x128::num_limbs == 2);
+
+
+namespace {
+
+    u128
+    rand128()
+    {
+        return u128{utils::rand64()} << 64 | utils::rand64();
+    }
+
+
+    x128
+    make_x128(u128 v)
+    {
+        x128 r;
+        r.limb(0) = static_cast<std::uint64_t>(v);
+        r.limb(1) = static_cast<std::uint64_t>(v >> 64);
+        return r;
+    }
+
+
+    bool
+    same(const x128& x, u128 v)
+    {
+        return x.to_uint<128>() == v;
+    }
+
+}
+
+
+TEST_CASE("arithmetic", "[random][128]")
+{
+    for (unsigned i = 0; i < max_tries; ++i) {
+        u128 a = rand128();
+        u128 b = rand128() >> utils::rand(127);
+        x128 xa = make_x128(a);
+        x128 xb = make_x128(b);
+
+        CHECK(same(xa + xb, a + b));
+        CHECK(same(xa - xb, a - b));
+        CHECK(same(xa * xb, a * b));
+        if (b) {
+            auto [q, r] = div(xa, xb);
+            CHECK(same(q, a / b));
+            CHECK(same(r, a % b));
+        }
+
+        unsigned s = utils::rand(127);
+        CHECK(same(xa << s, a << s));
+        CHECK(same(xa >> s, a >> s));
+    }
+}
+
+
+TEST_CASE("limb division", "[random][128]")
+{
+    for (unsigned i = 0; i < max_tries; ++i) {
+        u128 a = rand128();
+        std::uint64_t b = utils::rand64();
+        if (!b)
+            continue;
+        x128 xa = make_x128(a);
+        auto [q, r] = div(xa, b);
+        CHECK(same(q, a / b));
+        CHECK(r == a % b);
+    }
+}
+
+
+TEST_CASE("construction and serialization", "[128]")
+{
+    using namespace xint::literals;
+
+    x128 a = ~std::uint64_t{0};
+    CHECK(a.to_hex() == "ffffffffffffffff");
+    CHECK(a.to_uint<64>() == ~std::uint64_t{0});
+
+    x128 b{"0x0123456789abcdeffedcba9876543210"};
+    CHECK(b.limb(0) == 0xfedcba9876543210ull);
+    CHECK(b.limb(1) == 0x0123456789abcdefull);
+    CHECK(b.to_hex() == "123456789abcdeffedcba9876543210");
+    CHECK(b.to_dec() == "1512366075204170947332355369683137040");
+
+    auto c = 0x123456789abcdeffedcba9876543210_uint;
+    static_assert(decltype(c)::num_bits == 128);
+    CHECK(c == b);
+
+    std::string ref = "340282366920938463463374607431768211455";
+    x128 d{ref};
+    CHECK(d.to_dec() == ref);
+    CHECK(!(d + 1u));
+}
+
+
+TEST_CASE("carry chains", "[random][limbs]")
+{
+    using xint::limb_type;
+    using std::vector;
+
+    // a limb with random bits, or all ones/zeros, to make long carry chains
+    auto rand_limb = []() -> limb_type
+    {
+        switch (utils::rand(3)) {
+            case 0:
+                return 0;
+            case 1:
+                return ~limb_type{0};
+            default:
+                return utils::rand64();
+        }
+    };
+
+    for (unsigned i = 0; i < 10000; ++i) {
+        const std::size_t n = utils::rand(13);
+        vector<limb_type> a(n);
+        vector<limb_type> b(n);
+        for (std::size_t j = 0; j < n; ++j) {
+            a[j] = rand_limb();
+            b[j] = rand_limb();
+        }
+        const limb_type m = rand_limb();
+
+        // the same operations on 128-bit numbers, one limb at a time
+        vector<limb_type> sum(n);
+        vector<limb_type> diff(n);
+        vector<limb_type> prod(n);
+        vector<limb_type> acc = b;
+        u128 sum_carry = 0;
+        u128 diff_borrow = 0;
+        u128 prod_carry = 0;
+        u128 acc_carry = 0;
+        for (std::size_t j = 0; j < n; ++j) {
+            sum_carry += u128{a[j]} + b[j];
+            sum[j] = static_cast<limb_type>(sum_carry);
+            sum_carry >>= 64;
+
+            const u128 d = u128{a[j]} - b[j] - diff_borrow;
+            diff[j] = static_cast<limb_type>(d);
+            diff_borrow = d >> 127;
+
+            prod_carry += u128{a[j]} * m;
+            prod[j] = static_cast<limb_type>(prod_carry);
+            prod_carry >>= 64;
+
+            acc_carry += u128{a[j]} * m + acc[j];
+            acc[j] = static_cast<limb_type>(acc_carry);
+            acc_carry >>= 64;
+        }
+
+        vector<limb_type> out(n);
+        CHECK(xint::detail::add_n(out.data(), a.data(), b.data(), n) == sum_carry);
+        CHECK(out == sum);
+        CHECK(xint::detail::sub_n(out.data(), a.data(), b.data(), n) == diff_borrow);
+        CHECK(out == diff);
+        CHECK(xint::detail::mul_1(out.data(), a.data(), n, m) == prod_carry);
+        CHECK(out == prod);
+        out = b;
+        CHECK(xint::detail::addmul_1(out.data(), a.data(), n, m) == acc_carry);
+        CHECK(out == acc);
+
+        // in place
+        out = a;
+        CHECK(xint::detail::add_n(out.data(), out.data(), b.data(), n) == sum_carry);
+        CHECK(out == sum);
+        out = a;
+        CHECK(xint::detail::sub_n(out.data(), out.data(), b.data(), n) == diff_borrow);
+        CHECK(out == diff);
+        out = a;
+        CHECK(xint::detail::mul_1(out.data(), out.data(), n, m) == prod_carry);
+        CHECK(out == prod);
+    }
+}
+
+
+#if XINT_DISPATCH
+
+TEST_CASE("backends", "[dispatch]")
+{
+    using xint::hw::backend;
+
+    const backend saved = xint::hw::current_backend();
+    CHECK(xint::hw::supported(backend::portable));
+    CHECK(xint::hw::supported(xint::hw::best_backend()));
+
+    auto check = []<unsigned Bits>(xint::uint<Bits>)
+    {
+        using U = xint::uint<Bits>;
+        using W = xint::uint<2 * Bits>;
+
+        auto random = []
+        {
+            U r;
+            for (auto& x : r.limbs())
+                x = utils::rand64();
+            return r;
+        };
+
+        for (unsigned i = 0; i < 100; ++i) {
+            // the first round has the largest values
+            const U a = i ? random() : ~U{0};
+            const U b = i ? random() : ~U{0};
+            U m = i ? random() : ~U{0};
+            m.limb(0) |= 1;
+            const xint::montgomery<U> mont{m};
+            const U am = a % m;
+            const U bm = b % m;
+
+            // the portable backend gives the reference results
+            xint::hw::set_backend(backend::portable);
+            const W prod = W{a} * W{b};
+            const W square = sqr(W{a});
+            const U sum = a + b;
+            const U diff = a - b;
+            const U mont_prod = mont.mul(am, bm);
+
+            for (const auto& k : xint::hw::kernel_tables) {
+                if (!xint::hw::supported(k.id))
+                    continue;
+                INFO("backend " << k.name);
+                xint::hw::set_backend(k.id);
+                CHECK(xint::hw::current_backend() == k.id);
+                CHECK(W{a} * W{b} == prod);
+                CHECK(sqr(W{a}) == square);
+                CHECK(a + b == sum);
+                CHECK(a - b == diff);
+                CHECK(mont.mul(am, bm) == mont_prod);
+            }
+        }
+    };
+
+    check(xint::uint<320>{});  // 5 limbs
+    check(xint::uint<1088>{}); // 17 limbs
+    check(xint::uint<2112>{}); // 33 limbs
+    check(xint::uint<4096>{}); // 64 limbs
+
+    xint::hw::set_backend(saved);
+}
+
+#endif
@@ -0,0 +1,84 @@
+#include <cstdint>
+#include <stdexcept>
+
+#include <libxint/uint.hpp>
+#include <libxint/montgomery.hpp>
+
+#include "catch2/catch_amalgamated.hpp"
+#include "utils/random.hpp"
+
+
+const unsigned max_tries = 1000;
+
+
+TEST_CASE("inverse")
+{
+    for (unsigned i = 0; i < max_tries; ++i) {
+        xint::limb_type m = static_cast<xint::limb_type>(utils::rand64() | 1);
+        xint::limb_type inv = xint::eval_mont_inverse(m);
+        CHECK(static_cast<xint::limb_type>(m * inv) == static_cast<xint::limb_type>(-1));
+    }
+}
+
+
+TEST_CASE("random64", "[random][64]")
+{
+    using std::uint64_t;
+    using x64 = xint::uint<64>;
+
+    for (unsigned i = 0; i < max_tries; ++i) {
+        const uint64_t m = utils::rand64() | 1;
+        const uint64_t a = utils::rand64() % m;
+        const uint64_t b = utils::rand64() % m;
+        const uint64_t c = static_cast<unsigned __int128>(a) * b % m;
+        const uint64_t d = static_cast<unsigned __int128>(a) * a % m;
+
+        xint::montgomery<x64> mont{m};
+        x64 ma = mont.to_mont(a);
+        x64 mb = mont.to_mont(b);
+        CHECK(mont.from_mont(ma) == a);
+        CHECK(mont.from_mont(mont.mul(ma, mb)) == c);
+        CHECK(mont.from_mont(mont.sqr(ma)) == d);
+        CHECK(mont.from_mont(mont.one()) == (m == 1 ? 0 : 1));
+    }
+}
+
+
+TEMPLATE_TEST_CASE_SIG("random", "[random]",
+                       ((unsigned Bits), Bits), 128, 512, 2048)
+{
+    using U = xint::uint<Bits>;
+    using W = xint::uint<2 * Bits>;
+
+    for (unsigned i = 0; i < 100; ++i) {
+        U m = utils::random_uint<Bits>(utils::rand(2, Bits));
+        m.limb(0) |= 1;
+        const U a = utils::random_uint<Bits>() % m;
+        const U b = utils::random_uint<Bits>() % m;
+
+        xint::montgomery<U> mont{m};
+        const U ma = mont.to_mont(a);
+        const U mb = mont.to_mont(b);
+        CHECK(mont.from_mont(ma) == a);
+        CHECK(mont.from_mont(mont.mul(ma, mb)) == U{W{a} * W{b} % W{m}});
+
+        // x^y, checked against the square-and-multiply on a wider type
+        const U y = utils::random_uint<Bits>(utils::rand(1, 64));
+        W ref = 1;
+        const W wm = m;
+        W wx = a;
+        for (unsigned j = 0; j < bit_width(y); ++j) {
+            if (bit_get(y, j))
+                ref = ref * wx % wm;
+            wx = wx * wx % wm;
+        }
+        CHECK(mont.from_mont(mont.pow(ma, y)) == U{ref});
+    }
+}
+
+
+TEST_CASE("even modulus")
+{
+    using x64 = xint::uint<64>;
+    CHECK_THROWS_AS(xint::montgomery<x64>{x64{100}}, std::domain_error);
+}
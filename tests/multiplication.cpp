@@ -44,3 +44,210 @@ TEST_CASE("special inplace", "[64]")
     }
 
 }
+
+
+TEST_CASE("overflow", "[64]")
+{
+    using x64s = xint::uint<64, true>;
+
+    // the product only has non-zero bits above the 64th
+    x64s a = std::uint64_t{1} << 32;
+    CHECK_THROWS_AS(a * a, std::overflow_error);
+
+    x64s b = std::uint64_t{1} << 31;
+    CHECK(a * b == std::uint64_t{1} << 63);
+}
+
+
+TEST_CASE("mixed widths", "[random][64]")
+{
+    using std::uint32_t;
+    using std::uint64_t;
+    using x32 = xint::uint<32>;
+    using x64 = xint::uint<64>;
+    using x128 = xint::uint<128>;
+
+    for (unsigned i = 0; i < max_tries; ++i) {
+        uint32_t a = utils::rand32();
+        uint32_t b = utils::rand32();
+        uint64_t c = uint64_t{a} * b;
+
+        x32 xa = a;
+        x32 xb = b;
+        x64 xc;
+        CHECK(!xint::eval_mul_simple(xc.limbs(), xa.limbs(), xb.limbs()));
+        CHECK(xc == c);
+
+        // out is larger than both
+        x128 xd;
+        CHECK(!xint::eval_mul_simple(xd.limbs(), xa.limbs(), xb.limbs()));
+        CHECK(xd == c);
+
+        // truncated to a single limb
+        std::array<xint::limb_type, 1> xe;
+        bool overflow = xint::eval_mul_simple(xe, xa.limbs(), xb.limbs());
+        CHECK(overflow == (c >> xint::limb_bits != 0));
+        CHECK(xe[0] == static_cast<xint::limb_type>(c));
+    }
+}
+
+
+TEMPLATE_TEST_CASE_SIG("karatsuba", "[karatsuba][random]",
+                       ((unsigned Bits), Bits), 256, 1024, 4096)
+{
+    using U = xint::uint<Bits>;
+    using W = xint::uint<2 * Bits>;
+
+    static_assert(U::num_limbs >= xint::karatsuba_threshold);
+
+    for (unsigned i = 0; i < 100; ++i) {
+        const unsigned a_bits = utils::rand(1, Bits);
+        const unsigned b_bits = utils::rand(1, Bits);
+        U a = utils::random_uint<Bits>(a_bits);
+        U b = utils::random_uint<Bits>(b_bits);
+
+        // full product, computed by both kernels
+        W ref;
+        W out;
+        xint::detail::karatsuba_buffer_t<U::num_limbs> buf;
+        CHECK(!xint::eval_mul_simple(ref.limbs(), a.limbs(), b.limbs()));
+        CHECK(!xint::eval_mul_karatsuba(out.limbs(), a.limbs(), b.limbs(), buf.limbs()));
+        CHECK(out == ref);
+
+        // truncated product, overflow must match
+        U trunc;
+        bool overflow = xint::eval_mul_simple(trunc.limbs(), a.limbs(), b.limbs());
+        CHECK(a * b == trunc);
+        CHECK(overflow == (bit_width(ref) > Bits));
+        CHECK(overflow == xint::eval_mul_karatsuba(out.limbs() | std::views::take(U::num_limbs),
+                                                   a.limbs(),
+                                                   b.limbs(),
+                                                   buf.limbs()));
+    }
+}
+
+
+TEMPLATE_TEST_CASE_SIG("squaring", "[sqr][random]",
+                       ((unsigned Bits), Bits), 64, 256, 1024, 4096)
+{
+    using U = xint::uint<Bits>;
+    using W = xint::uint<2 * Bits>;
+
+    for (unsigned i = 0; i < 100; ++i) {
+        U a = utils::random_uint<Bits>(utils::rand(1, Bits));
+        const U b = a;
+
+        // full square
+        W ref;
+        W out;
+        CHECK(!xint::eval_mul_simple(ref.limbs(), a.limbs(), b.limbs()));
+        CHECK(!xint::eval_sqr_simple(out.limbs(), a.limbs()));
+        CHECK(out == ref);
+
+        xint::detail::karatsuba_buffer_t<U::num_limbs> buf;
+        CHECK(!xint::eval_sqr_karatsuba(out.limbs(), a.limbs(), buf.limbs()));
+        CHECK(out == ref);
+
+        // truncated square, overflow must match
+        U trunc;
+        U trunc_sqr;
+        bool overflow = xint::eval_mul_simple(trunc.limbs(), a.limbs(), b.limbs());
+        CHECK(overflow == xint::eval_sqr_simple(trunc_sqr.limbs(), a.limbs()));
+        CHECK(trunc_sqr == trunc);
+
+        CHECK(sqr(a) == trunc);
+        CHECK(a * a == trunc);
+        a *= a;
+        CHECK(a == trunc);
+    }
+}
+
+
+TEST_CASE("squaring overflow", "[sqr][64]")
+{
+    using x64s = xint::uint<64, true>;
+
+    x64s a = std::uint64_t{1} << 32;
+    CHECK_THROWS_AS(sqr(a), std::overflow_error);
+    CHECK_THROWS_AS(a * a, std::overflow_error);
+
+    x64s b = (std::uint64_t{1} << 32) - 1;
+    CHECK(sqr(b) == b * x64s{b});
+}
+
+
+TEMPLATE_TEST_CASE_SIG("widening", "[wide][random]",
+                       ((unsigned Bits), Bits), 64, 256, 1024, 4096)
+{
+    using U = xint::uint<Bits>;
+    using W = xint::uint<2 * Bits>;
+    using H = xint::uint<Bits / 2>;
+
+    for (unsigned i = 0; i < 100; ++i) {
+        const U a = utils::random_uint<Bits>(utils::rand(1, Bits));
+        const U b = utils::random_uint<Bits>(utils::rand(1, Bits));
+        const U c = utils::random_uint<Bits>(utils::rand(1, Bits));
+        const W ref = W{a} * W{b};
+
+        CHECK(mul_wide(a, b) == ref);
+        CHECK(mul_hi(a, b) == U{ref >> Bits});
+        CHECK(mul_add(a, b, c) == ref + c);
+
+        // mixed widths
+        const H h = utils::random_uint<Bits / 2>(utils::rand(1, Bits / 2));
+        const auto wide = mul_wide(a, h);
+        static_assert(decltype(wide)::num_bits == Bits + Bits / 2);
+        CHECK(wide == W{a} * W{h});
+        CHECK(mul_hi(h, a) == U{wide >> Bits});
+        CHECK(mul_add(h, a, h) == W{a} * W{h} + h);
+    }
+
+    // the column below the upper half is all ones, the skipped products carry into it
+    const U ones = ~U{0};
+    for (unsigned k = 0; k < 20; ++k) {
+        const U b = k;
+        CHECK(mul_hi(ones, b) == U{k ? k - 1 : 0});
+        CHECK(mul_hi(b, ones) == U{k ? k - 1 : 0});
+        CHECK(mul_hi(ones, U{ones - k}) == U{ones - k - 1});
+    }
+
+    // the largest result
+    CHECK(mul_add(ones, ones, ones) == W{ones} << Bits);
+}
+
+
+TEMPLATE_TEST_CASE_SIG("fixed", "[fixed][random]",
+                       ((unsigned Bits), Bits), 8, 16, 32, 128)
+{
+    using U = xint::uint<Bits>;
+    using W = xint::uint<2 * Bits>;
+
+    static_assert(U::num_limbs <= xint::utils::unroll_limbs);
+
+    for (unsigned i = 0; i < 1000; ++i) {
+        const U a = utils::random_uint<Bits>(utils::rand(1, Bits));
+        const U b = utils::random_uint<Bits>(utils::rand(1, Bits));
+
+        W ref;
+        CHECK(!xint::eval_mul_simple(ref.limbs(), a.limbs(), b.limbs()));
+
+        U out;
+        bool overflow = xint::eval_mul_fixed(out.limbs(), a.limbs(), b.limbs());
+        CHECK(overflow == (bit_width(ref) > Bits));
+        CHECK(out == U{ref & W{~U{0}}});
+
+        const xint::limb_type c = b.limb(0);
+        CHECK(!xint::eval_mul_simple(ref.limbs(), a.limbs(), std::array{c}));
+        overflow = xint::eval_mul_limb_fixed(out.limbs(), a.limbs(), c);
+        CHECK(overflow == (bit_width(ref) > Bits));
+        CHECK(out == U{ref & W{~U{0}}});
+    }
+
+    // the top limb of the product lands just past the end
+    const U ones = ~U{0};
+    U out;
+    CHECK(xint::eval_mul_fixed(out.limbs(), ones.limbs(), ones.limbs()));
+    CHECK(out == 1);
+    CHECK(!xint::eval_mul_fixed(out.limbs(), ones.limbs(), U{1}.limbs()));
+    CHECK(out == ones);
+}
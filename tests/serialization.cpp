@@ -1,11 +1,19 @@
+#include <array>
+#include <bit>
+#include <charconv>
+#include <cstddef>
 #include <cstdint>
 #include <iomanip>
+#include <list>
+#include <memory> // to_address()
 #include <ostream>
+#include <sstream>
 #include <string>
 
 #include <libxint/uint.hpp>
 
 #include "catch2/catch_amalgamated.hpp"
+#include "utils/random.hpp"
 
 
 using std::string;
@@ -48,6 +56,290 @@ TEST_CASE("zero")
 }
 
 
+// one digit per division, like the conversion used to be done
+template<unsigned Bits>
+string
+ref_to_string(xint::uint<Bits> n,
+              unsigned base)
+{
+    if (!n)
+        return "0";
+    string result;
+    while (n) {
+        auto [q, d] = xint::div(n, base);
+        result.insert(result.begin(), "0123456789abcdefghijklmnopqrstuvwxyz"[d]);
+        n = q;
+    }
+    return result;
+}
+
+
+TEMPLATE_TEST_CASE_SIG("radix", "[random]",
+                       ((unsigned Bits), Bits), 64, 1024, 8192)
+{
+    using U = xint::uint<Bits>;
+
+    auto check = [](const U& a, unsigned base)
+    {
+        const string s = a.to_string(base);
+        CHECK(s == ref_to_string(a, base));
+        CHECK(U{s, base} == a);
+    };
+
+    for (unsigned i = 0; i < 3; ++i) {
+        U a;
+        for (auto& x : a.limbs())
+            x = static_cast<xint::limb_type>(utils::rand64());
+        a >>= utils::rand(0, Bits - 1);
+        for (unsigned base : {2u, 3u, 7u, 8u, 10u, 16u, 32u, 36u})
+            check(a, base);
+        CHECK(a.to_dec() == a.to_string(10));
+        CHECK(a.to_string(16, true) == a.to_hex(true));
+    }
+
+    // long runs of zeros and of nines, inside the chunks and across the splits
+    const unsigned step = Bits > 1024 ? 97 : 1;
+    U p = 1;
+    for (unsigned k = 0; p <= std::numeric_limits<U>::max() / 10u; ++k) {
+        if (k % step == 0) {
+            check(p, 10);
+            check(U{p - 1u}, 10);
+            check(U{p + 1u}, 10);
+        }
+        p *= 10u;
+    }
+    check(std::numeric_limits<U>::max(), 10);
+}
+
+
+TEMPLATE_TEST_CASE_SIG("charconv", "[random]",
+                       ((unsigned Bits), Bits), 64, 1024, 8192)
+{
+    using U = xint::uint<Bits>;
+
+    for (unsigned i = 0; i < 5; ++i) {
+        U a;
+        for (auto& x : a.limbs())
+            x = static_cast<xint::limb_type>(utils::rand64());
+        a >>= utils::rand(0, Bits - 1);
+
+        for (int base = 2; base <= 36; ++base) {
+            const string ref = a.to_string(base);
+            string buf(ref.size() + 3, '#');
+
+            // exactly enough room, and more than enough
+            for (std::size_t size : {ref.size(), buf.size()}) {
+                auto [ptr, ec] = xint::to_chars(buf.data(), buf.data() + size, a, base);
+                REQUIRE(ec == std::errc{});
+                CHECK(string(buf.data(), ptr) == ref);
+            }
+
+            // not enough room
+            auto [ptr, ec] = xint::to_chars(buf.data(), buf.data() + ref.size() - 1, a, base);
+            CHECK(ec == std::errc::value_too_large);
+            CHECK(ptr == buf.data() + ref.size() - 1);
+
+            // with something after the digits
+            const string in = ref + "!0";
+            U b = 1;
+            auto [end, ec2] = xint::from_chars(in.data(), in.data() + in.size(), b, base);
+            CHECK(ec2 == std::errc{});
+            CHECK(end == in.data() + ref.size());
+            CHECK(b == a);
+        }
+    }
+}
+
+
+TEST_CASE("charconv 64")
+{
+    using x64 = xint::uint<64>;
+
+    char buf[70];
+    char ref[70];
+    for (unsigned i = 0; i < 1000; ++i) {
+        const uint64_t v = utils::rand64() >> utils::rand(0, 63);
+        const int base = utils::rand(2, 36);
+        auto [p, ec] = xint::to_chars(buf, buf + sizeof buf, x64{v}, base);
+        auto [q, ec2] = std::to_chars(ref, ref + sizeof ref, v, base);
+        REQUIRE(ec == std::errc{});
+        REQUIRE(ec2 == std::errc{});
+        CHECK(string(buf, p) == string(ref, q));
+    }
+
+    x64 a = 7;
+    const string big = "18446744073709551616";
+    auto [p, ec] = xint::from_chars(big.data(), big.data() + big.size(), a);
+    CHECK(ec == std::errc::result_out_of_range);
+    CHECK(p == big.data() + big.size());
+    CHECK(a == 7u);
+
+    const string bad = "-1";
+    auto [q, ec2] = xint::from_chars(bad.data(), bad.data() + bad.size(), a);
+    CHECK(ec2 == std::errc::invalid_argument);
+    CHECK(q == bad.data());
+    CHECK(a == 7u);
+
+    const string hex = "0x1F";
+    auto [r, ec3] = xint::from_chars(hex.data(), hex.data() + hex.size(), a, 16);
+    CHECK(ec3 == std::errc{});
+    CHECK(r == hex.data() + 1);
+    CHECK(a == 0u);
+    auto [s, ec4] = xint::from_chars(hex.data() + 2, hex.data() + hex.size(), a, 16);
+    CHECK(ec4 == std::errc{});
+    CHECK(s == hex.data() + hex.size());
+    CHECK(a == 0x1fu);
+
+    auto [t, ec5] = xint::to_chars(buf, buf, x64{0});
+    CHECK(ec5 == std::errc::value_too_large);
+    CHECK(t == buf);
+    auto [u, ec6] = xint::to_chars(buf, buf + 1, x64{0});
+    CHECK(ec6 == std::errc{});
+    CHECK(string(buf, u) == "0");
+}
+
+
+TEST_CASE("stream input")
+{
+    auto read = [](const string& text,
+                   std::ios_base::fmtflags base) -> std::pair<x64, std::istringstream>
+    {
+        std::pair<x64, std::istringstream> r{7, std::istringstream{text}};
+        r.second.setf(base, std::ios_base::basefield);
+        r.second >> r.first;
+        return r;
+    };
+
+    auto rest = [](std::istringstream& in) -> string
+    {
+        in.clear();
+        return string(std::istreambuf_iterator<char>{in}, {});
+    };
+
+    const auto dec = std::ios_base::dec;
+    const auto hex = std::ios_base::hex;
+    const auto oct = std::ios_base::oct;
+    const std::ios_base::fmtflags none{};
+
+    {
+        auto [a, in] = read("  12345678901234567 rest", dec);
+        CHECK(in);
+        CHECK(a == uint64_t{12345678901234567u});
+        CHECK(rest(in) == " rest");
+    }
+    {
+        auto [a, in] = read("018446744073709551615", dec);
+        CHECK(in);
+        CHECK(in.eof());
+        CHECK(a == std::numeric_limits<x64>::max());
+    }
+    {
+        auto [a, in] = read("18446744073709551616!", dec);
+        CHECK(in.fail());
+        CHECK(a == std::numeric_limits<x64>::max());
+        CHECK(rest(in) == "!");
+    }
+    {
+        auto [a, in] = read("abc", dec);
+        CHECK(in.fail());
+        CHECK(a == 0u);
+        CHECK(rest(in) == "abc");
+    }
+
+    CHECK(read("0xFFff", hex).first == 0xffffu);
+    CHECK(read("0Xab", hex).first == 0xabu);
+    CHECK(read("ffffffffffffffff", hex).first == std::numeric_limits<x64>::max());
+    CHECK(read("1ffffffffffffffff", hex).second.fail());
+    {
+        auto [a, in] = read("0xg", hex);
+        CHECK(in);
+        CHECK(a == 0u);
+        CHECK(rest(in) == "xg");
+    }
+    CHECK(read("0b1", hex).first == 0xb1u);
+
+    CHECK(read("17", oct).first == 15u);
+    CHECK(read("017", oct).first == 15u);
+    CHECK(read("0o17", oct).first == 15u);
+    CHECK(read("18", oct).first == 1u);
+    CHECK(read("0001777777777777777777777", oct).first == std::numeric_limits<x64>::max());
+    CHECK(read("2000000000000000000000", oct).second.fail());
+
+    CHECK(read("0x10", none).first == 16u);
+    CHECK(read("0b101", none).first == 5u);
+    CHECK(read("0o17", none).first == 15u);
+    CHECK(read("017", none).first == 15u);
+    CHECK(read("19", none).first == 19u);
+    {
+        auto [a, in] = read("0", none);
+        CHECK(in);
+        CHECK(in.eof());
+        CHECK(a == 0u);
+    }
+    {
+        std::istringstream in{"1 22\n333"};
+        x64 a, b, c;
+        in >> a >> b >> c;
+        CHECK(in);
+        CHECK(a == 1u);
+        CHECK(b == 22u);
+        CHECK(c == 333u);
+    }
+
+    // round trip, in every base
+    using x1024 = xint::uint<1024>;
+    for (unsigned i = 0; i < 20; ++i) {
+        x1024 a;
+        for (auto& x : a.limbs())
+            x = static_cast<xint::limb_type>(utils::rand64());
+        a >>= utils::rand(0, 1023);
+        for (auto base : {dec, hex, oct}) {
+            std::stringstream ss;
+            ss.setf(base, std::ios_base::basefield);
+            ss << a << ' ' << a;
+            x1024 b, c;
+            ss >> b >> c;
+            CHECK(ss);
+            CHECK(b == a);
+            CHECK(c == a);
+        }
+    }
+}
+
+
+#if __cpp_lib_format >= 201907L
+
+TEST_CASE("format")
+{
+    using x256 = xint::uint<256>;
+
+    const x256 a{"123456789012345678901234567890", 10};
+    CHECK(std::format("{}", a) == "123456789012345678901234567890");
+    CHECK(std::format("{:d}", x256{0}) == "0");
+    CHECK(std::format("{:x}", x256{255}) == "ff");
+    CHECK(std::format("{:#X}", x256{255}) == "0XFF");
+    CHECK(std::format("{:#b}", x256{5}) == "0b101");
+    CHECK(std::format("{:#o}", x256{8}) == "010");
+    CHECK(std::format("{:#o}", x256{0}) == "0");
+    CHECK(std::format("{:+}", x256{42}) == "+42");
+    CHECK(std::format("{:8}", x256{42}) == "      42");
+    CHECK(std::format("{:*<8}", x256{42}) == "42******");
+    CHECK(std::format("{:^7}", x256{42}) == "  42   ");
+    CHECK(std::format("{:#010x}", x256{255}) == "0x000000ff");
+    CHECK(std::format("{:{}}", x256{42}, 5) == "   42");
+    CHECK(std::format("{:x}", a) == a.to_hex());
+    CHECK(std::format(std::locale::classic(), "{:L}", a) == "123456789012345678901234567890");
+    CHECK_THROWS_AS(std::vformat("{:c}", std::make_format_args(a)), std::format_error);
+    CHECK_THROWS_AS(std::vformat("{:.2}", std::make_format_args(a)), std::format_error);
+
+    using x4096 = xint::uint<4096>;
+    const x4096 b = x4096{1} << 4095;
+    CHECK(std::format("{:#x}", b) == "0x8" + string(1023, '0'));
+}
+
+#endif
+
+
 TEST_CASE("endian")
 {
     {
@@ -88,11 +380,50 @@ TEST_CASE("endian")
     }
 
     {
-        // x128 a{1u};
-        // std::array<unsigned char, 16> data;
-        // a.to_little_endian(data);
+        x128 a{"0x00112233445566778899aabbccddeeff"};
+
+        uvector data(16);
+        a.to_little_endian(data);
+        CHECK(x128::from_little_endian(data) == a);
+        a.to_big_endian(data);
+        CHECK(x128::from_big_endian(data) == a);
+        CHECK(x128::from_little_endian(data) == x128{"0xffeeddccbbaa99887766554433221100"});
+
+        // through std::byte and through a range that isn't contiguous
+        std::array<std::byte, 16> bytes;
+        CHECK(std::to_address(a.to_big_endian(bytes)) == bytes.data() + bytes.size());
+        CHECK(std::bit_cast<std::array<unsigned char, 16>>(bytes)[0] == 0x00);
+        CHECK(std::bit_cast<std::array<unsigned char, 16>>(bytes)[15] == 0xff);
+        CHECK(x128::from_big_endian(bytes) == a);
+        a.to_little_endian(bytes);
+        CHECK(x128::from_little_endian(std::span<const std::byte>{bytes}) == a);
+
+        std::list<unsigned char> lst(16);
+        a.to_big_endian(lst);
+        CHECK(equal(lst, data));
+        CHECK(x128::from_big_endian(lst) == a);
+        a.to_little_endian(lst);
+        CHECK(x128::from_little_endian(lst) == a);
 
+        data.resize(15);
+        CHECK_THROWS_AS(x128::from_little_endian(data), std::out_of_range);
+        CHECK_THROWS_AS(x128::from_big_endian(std::span{bytes}.first(15)), std::out_of_range);
+        lst.pop_back();
+        CHECK_THROWS_AS(x128::from_big_endian(lst), std::out_of_range);
     }
 
+    {
+        using x4096 = xint::uint<4096>;
+        x4096 a;
+        for (auto& x : a.limbs())
+            x = static_cast<xint::limb_type>(utils::rand64());
 
+        uvector data(512);
+        a.to_little_endian(data);
+        CHECK(x4096::from_little_endian(data) == a);
+        CHECK(data[0] == (a.limb(0) & 0xff));
+        a.to_big_endian(data);
+        CHECK(x4096::from_big_endian(data) == a);
+        CHECK(data[511] == (a.limb(0) & 0xff));
+    }
 }
@@ -103,3 +103,62 @@ TEST_CASE("lcm random 64", "[lcm][random][64]")
         CHECK(lcm(xa, xb) == c);
     }
 }
+
+
+TEST_CASE("powm special", "[powm][64]")
+{
+    using x64 = xint::uint<64>;
+
+    CHECK(powm(x64{2}, x64{10}, x64{1000}) == 24);
+    CHECK(powm(x64{3}, x64{0}, x64{7}) == 1);
+    CHECK(powm(x64{0}, x64{5}, x64{7}) == 0);
+    CHECK(powm(x64{5}, x64{1}, x64{3}) == 2);
+    CHECK(powm(x64{5}, x64{3}, x64{1}) == 0);
+    // Fermat's little theorem
+    CHECK(powm(x64{123456}, x64{65536}, x64{65537}) == 1);
+
+    // heap values, with the widest window
+    using x1024 = xint::uint<1024>;
+    using x4096 = xint::uint<4096>;
+    static_assert(!x4096::is_local);
+    const x1024 y = (x1024{1} << 700) + 12345;
+    const x1024 m = 1000000007;
+    CHECK(powm(x4096{3}, x4096{y}, x4096{m}) == powm(x1024{3}, y, m));
+}
+
+
+TEST_CASE("powm random", "[powm][random]")
+{
+    using U = xint::uint<256>;
+    using W = xint::uint<512>;
+
+    for (unsigned i = 0; i < 100; ++i) {
+        U x;
+        U y;
+        U m;
+        for (auto& v : x.limbs())
+            v = static_cast<xint::limb_type>(utils::rand64());
+        for (auto& v : y.limbs())
+            v = static_cast<xint::limb_type>(utils::rand64());
+        for (auto& v : m.limbs())
+            v = static_cast<xint::limb_type>(utils::rand64());
+        // the products must fit in U
+        m >>= utils::rand(128, 255);
+        // cover all window sizes
+        y >>= utils::rand(255);
+        if (!m)
+            continue;
+
+        // reference: plain square-and-multiply, with wider products
+        const W wm = m;
+        W ref = 1;
+        W wx = W{x} % wm;
+        for (unsigned b = 0; b < bit_width(y); ++b) {
+            if (bit_get(y, b))
+                ref = ref * wx % wm;
+            wx = wx * wx % wm;
+        }
+
+        CHECK(powm(x, y, m) == U{ref});
+    }
+}
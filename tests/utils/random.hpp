@@ -2,6 +2,16 @@
 #define TESTS_UTILS_RANDOM_HPP
 
 #include <cstdint>
+#include <type_traits>
+
+
+namespace xint {
+
+    template<unsigned Bits,
+             bool Safe>
+    struct uint;
+
+}
 
 
 namespace utils {
@@ -12,6 +22,20 @@ namespace utils {
     std::uint32_t rand32();
     std::uint64_t rand64();
 
+
+    // a random xint::uint<Bits>, where only the lowest `top_bits` bits can be set
+    template<unsigned Bits>
+    xint::uint<Bits, false>
+    random_uint(unsigned top_bits = Bits)
+    {
+        xint::uint<Bits, false> r;
+        for (auto& x : r.limbs())
+            x = static_cast<std::remove_cvref_t<decltype(x)>>(rand64());
+        if (top_bits < Bits)
+            r >>= Bits - top_bits;
+        return r;
+    }
+
 }
 
 #endif